@@ -0,0 +1,30 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include <Benchmark.h>
+
+
+using namespace std;
+
+// 4Trace-bench [json] [samples]: the primitive microbenchmarks, see
+// Benchmark::bench_primitives(). Build target Bench, -O2 like Release
+int main(int argc, char* argv[])
+{
+    string json = argc > 1 ? argv[1] : "";
+    size_t samples = argc > 2 ? strtoul(argv[2], nullptr, 10) : 101;
+
+    try{
+        Benchmark bench;
+        bench.bench_primitives(json, samples);
+    }
+    catch(const char* error){
+        cerr << error << endl;
+        return 1;
+    }
+    catch(const exception& error){
+        cerr << error.what() << endl;
+        return 1;
+    }
+    return 0;
+}
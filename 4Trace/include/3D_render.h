@@ -1,19 +0,0 @@
-#ifndef RENDER_3D_H
-#define RENDER_3D_H
-
-namespace ren3d{
-class Render3D
-{
-    public:
-        Render3D() {};
-
-        void render_fct();
-
-    protected:
-
-    private:
-};
-
-}
-
-#endif // 3D_RENDER_H
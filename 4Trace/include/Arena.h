@@ -0,0 +1,136 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+/*******************************************************************************
+Arena class
+    bump allocator for the transient data of one thread. Allocations are a
+    pointer increment in the current block and are all released at once by
+    reset(), nothing is freed on its own. When a block is full a bigger one
+    is chained; reset() folds the chain in a single block of the peak size,
+    so after the first tiles (or frames) a thread runs without malloc. Only
+    trivially destructible types can live in it, nothing is destroyed
+*******************************************************************************/
+
+// usage of one or more arenas, in bytes
+struct ArenaStats{
+    size_t used = 0;               // since the last reset
+    size_t peak = 0;               // highest used since construction
+    size_t capacity = 0;           // bytes held from the system
+    size_t system_allocations = 0; // blocks allocated since construction
+
+    ArenaStats& operator+=(const ArenaStats& other);
+};
+
+class Arena{
+private:
+    struct Block{
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+    std::vector<Block> blocks; // the last one is being filled
+
+    size_t offset;   // in the last block
+    size_t retired;  // used bytes of the full blocks
+    size_t initial;  // size of the first block
+    ArenaStats usage;
+
+    void grow(size_t bytes);
+
+public:
+    // first block of initial bytes, allocated on first use
+    explicit Arena(size_t initial = 64 * 1024);
+
+    Arena(Arena&&) = default;
+    Arena& operator=(Arena&&) = default;
+
+    // size bytes aligned to align (a power of 2), uninitialized
+    void* allocate(size_t size, size_t align = alignof(std::max_align_t)){
+        if(!blocks.empty()){
+            size_t start = (offset + align - 1) & ~(align - 1);
+            if(start + size <= blocks.back().size){
+                offset = start + size;
+                size_t used = retired + offset;
+                if(used > usage.peak) {usage.peak = used;}
+                return blocks.back().data.get() + start;
+            }
+        }
+        grow(size + align);
+        return allocate(size, align);
+    }
+
+    // n default constructed T
+    template<typename T>
+    T* allocate(size_t n){
+        static_assert(std::is_trivially_destructible<T>::value, "the arena doesn't call destructors");
+        T* items = static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+        for(size_t i = 0; i < n; i++){
+            new (items + i) T();
+        }
+        return items;
+    }
+
+    // releases every allocation, the memory is kept for the next ones
+    void reset();
+
+    ArenaStats stats() const;
+};
+
+/*******************************************************************************
+ArenaArray class
+    typed pool taken from an arena: a fixed capacity array with the
+    interface of a vector, valid until the arena is reset. The capacity is
+    given up front, push_back() doesn't check it
+*******************************************************************************/
+
+template<typename T>
+class ArenaArray{
+    static_assert(std::is_trivially_destructible<T>::value, "the arena doesn't call destructors");
+
+private:
+    T* items = nullptr;
+    size_t count = 0, slots = 0;
+
+public:
+    // room for n items, the array is emptied
+    void reserve(Arena& arena, size_t n){
+        items = static_cast<T*>(arena.allocate(n * sizeof(T), alignof(T)));
+        count = 0;
+        slots = n;
+    }
+
+    // n items left uninitialized, for types without constructor
+    void resize(Arena& arena, size_t n){
+        static_assert(std::is_trivially_default_constructible<T>::value, "the items need a value");
+        reserve(arena, n);
+        count = n;
+    }
+
+    // n copies of value
+    void assign(Arena& arena, size_t n, const T& value){
+        reserve(arena, n);
+        for(size_t i = 0; i < n; i++){
+            new (items + i) T(value);
+        }
+        count = n;
+    }
+
+    void push_back(const T& value) {new (items + count++) T(value);}
+    void clear() {count = 0;}
+
+    size_t size() const {return count;}
+    size_t capacity() const {return slots;}
+
+    T* data() {return items;}
+    const T* data() const {return items;}
+
+    T& operator[](size_t i) {return items[i];}
+    const T& operator[](size_t i) const {return items[i];}
+};
+
+#endif // ARENA_H
@@ -0,0 +1,22 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <cstddef>
+#include <string>
+
+class Benchmark{
+
+public:
+    Benchmark(){};
+    void bench_encoders(size_t width = 3840, size_t height = 2160, size_t repeats = 5);
+    void bench_render(size_t width = 1280, size_t height = 960, size_t repeats = 5);
+    void bench_lights(size_t width = 640, size_t height = 480, size_t repeats = 3);
+
+    // vector, matrix, sphere and bmp primitives one by one, median, p99
+    // and median absolute deviation of the time per call over the samples.
+    // Written as JSON to json when given
+    void bench_primitives(const std::string& json = "", size_t samples = 101);
+};
+
+
+#endif // BENCHMARK_H
@@ -0,0 +1,103 @@
+#ifndef DENOISER_H
+#define DENOISER_H
+
+#include <cstdint>
+#include <vector>
+#include <string>
+
+#include "ThreadPool.h"
+
+/*******************************************************************************
+AuxBuffers
+    per pixel data of the primary hits, kept next to the linear color when
+    a renderer is asked for it. Row major, row 0 is the top of the image
+    like bmp::Image. The normal is in camera coordinates (right, up,
+    backwards), the depth is the distance to the first hit and the id
+    tells the objects apart, the background has depth INFINITY and id 0.
+    diffuse is 1 where the first hit is a diffuse surface, the mirror and
+    glass pixels show other surfaces and are left alone by the denoiser.
+    ray_depth is the deepest bounce of the path of the pixel, 0 when the
+    primary ray ends it
+*******************************************************************************/
+
+struct AuxBuffers{
+    size_t width = 0, height = 0;
+
+    std::vector<float> color;  // r, g, b
+    std::vector<float> normal; // x, y, z
+    std::vector<float> depth;
+    std::vector<uint64_t> id;
+    std::vector<uint8_t> diffuse;
+    std::vector<uint8_t> ray_depth;
+
+    void resize(size_t w, size_t h);
+
+    // one file: "4TAUX2\n", the width and height as uint32, then the
+    // planes color, normal, depth, id, ray_depth and diffuse as stored,
+    // in the byte order of the machine
+    void write(const std::string& filename) const;
+
+    // one PFM file per channel: prefix_color.pfm, prefix_normal.pfm,
+    // prefix_depth.pfm, prefix_id.pfm and prefix_ray_depth.pfm. The id
+    // file has three channels, the shape, the low 24 bits of the index and
+    // the index >> 24, exact for indices below 2^48
+    void write_pfm(const std::string& prefix) const;
+
+    void set(size_t x, size_t y, const float rgb[3], const float n[3], float z, uint64_t object, bool is_diffuse, uint8_t bounces = 0){
+        size_t p = y * width + x;
+        color[3 * p] = rgb[0];
+        color[3 * p + 1] = rgb[1];
+        color[3 * p + 2] = rgb[2];
+        normal[3 * p] = n[0];
+        normal[3 * p + 1] = n[1];
+        normal[3 * p + 2] = n[2];
+        depth[p] = z;
+        id[p] = object;
+        diffuse[p] = is_diffuse;
+        ray_depth[p] = bounces;
+    }
+};
+
+/*******************************************************************************
+Denoiser class
+    edge avoiding a-trous wavelet filter: each pass is a 5x5 B3 spline
+    kernel whose taps are spread by 1, 2, 4, ... pixels, so a few passes
+    cover a wide footprint. Each tap is weighted by how much the neighbour
+    looks like the same surface: same object id, similar normal and depth,
+    and a color that isn't too far off. The color tolerance halves at every
+    pass, the first passes remove the noise and the later ones keep the
+    shadow edges. The rows are split across the thread pool, the inner
+    loops work on plain float arrays. The normal weight comes from a table
+    of pow(cosine, sigma_normal) and the luminances are computed once per
+    pass, so a tap costs a lookup and one exp
+*******************************************************************************/
+
+class Denoiser{
+private:
+    static constexpr size_t NORMAL_STEPS = 1024;
+
+    std::vector<float> scratch;
+    std::vector<float> luminance;
+    std::vector<float> normal_weight; // pow(k / NORMAL_STEPS, table_sigma)
+    float table_sigma = 0;
+
+    void pass(const AuxBuffers& aux, const float* in, float* out, size_t step, size_t row_begin, size_t row_end) const;
+
+public:
+    size_t iterations;
+    float sigma_color;  // luminance tolerance of the first pass
+    float sigma_normal; // exponent of the normal dot product
+    float sigma_depth;  // relative depth difference, per pixel of step
+
+    Denoiser(size_t iterations = 5, float sigma_color = 4, float sigma_normal = 64, float sigma_depth = 0.02) :
+        iterations(iterations),
+        sigma_color(sigma_color),
+        sigma_normal(sigma_normal),
+        sigma_depth(sigma_depth)
+        {}
+
+    // filters aux.color in place
+    void denoise(AuxBuffers& aux, ThreadPool& pool);
+};
+
+#endif // DENOISER_H
@@ -0,0 +1,105 @@
+#ifndef ENCODER_H
+#define ENCODER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <future>
+#include <memory>
+
+#include "bmp.h"
+#include "ThreadPool.h"
+
+/*******************************************************************************
+Encoder namespace
+    pluggable image writers for bmp::Image
+    BMP (24bit), PPM (binary P6), QOI and PNG (stored deflate, no zlib).
+    With a thread pool the rows are gathered in strips on its workers
+*******************************************************************************/
+
+namespace enc{
+
+    using Bytes = std::vector<uint8_t>;
+
+    class Encoder{
+    protected:
+        // splits the row serialization in strips, nullptr runs it inline
+        ThreadPool* workers;
+
+        // writes the rows [0, height) as packed RGB into dst, each row is
+        // placed at offset + y * stride; the rows are split in strips
+        void pack_rows(const bmp::Image& img, uint8_t* dst, size_t offset, size_t stride, bool bgr, bool bottom_up) const;
+
+    public:
+        Encoder(ThreadPool* pool = nullptr) : workers(pool) {}
+        virtual ~Encoder() {}
+
+        // the pool must not run another batch during an encode
+        ThreadPool* pool() const {return workers;}
+        void pool(ThreadPool* p) {workers = p;}
+
+        // file extension without the dot
+        virtual std::string extension() const = 0;
+
+        // encodes the image in out, out is resized and overwritten
+        virtual void encode(const bmp::Image& img, Bytes& out) const = 0;
+
+        Bytes encode(const bmp::Image& img) const;
+
+        // save image to file
+        void write(const bmp::Image& img, std::string filename) const;
+
+        // encode and save the image on a worker thread, the image is copied,
+        // the encoder must outlive the returned future
+        std::future<void> write_async(bmp::Image img, std::string filename) const;
+    };
+
+
+    class BMPEncoder : public Encoder{
+    public:
+        BMPEncoder(ThreadPool* pool = nullptr) : Encoder(pool) {}
+        std::string extension() const {return "bmp";}
+        using Encoder::encode;
+        void encode(const bmp::Image& img, Bytes& out) const;
+    };
+
+
+    class PPMEncoder : public Encoder{
+    public:
+        PPMEncoder(ThreadPool* pool = nullptr) : Encoder(pool) {}
+        std::string extension() const {return "ppm";}
+        using Encoder::encode;
+        void encode(const bmp::Image& img, Bytes& out) const;
+    };
+
+
+    // "Quite OK Image" format, the stream is sequential, only the pixel
+    // gathering is split in strips
+    class QOIEncoder : public Encoder{
+    public:
+        QOIEncoder(ThreadPool* pool = nullptr) : Encoder(pool) {}
+        std::string extension() const {return "qoi";}
+        using Encoder::encode;
+        void encode(const bmp::Image& img, Bytes& out) const;
+    };
+
+
+    // PNG with uncompressed (stored) deflate blocks, valid for any decoder
+    // and about as fast as the BMP writer
+    class PNGEncoder : public Encoder{
+    public:
+        PNGEncoder(ThreadPool* pool = nullptr) : Encoder(pool) {}
+        std::string extension() const {return "png";}
+        using Encoder::encode;
+        void encode(const bmp::Image& img, Bytes& out) const;
+    };
+
+
+    // returns the encoder matching the extension of filename (bmp if unknown)
+    std::unique_ptr<Encoder> from_filename(std::string filename, ThreadPool* pool = nullptr);
+
+    uint32_t crc32(const uint8_t* data, size_t len, uint32_t crc = 0);
+    uint32_t adler32(const uint8_t* data, size_t len, uint32_t adler = 1);
+}
+
+#endif // ENCODER_H
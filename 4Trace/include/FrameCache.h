@@ -0,0 +1,108 @@
+#ifndef FRAMECACHE_H
+#define FRAMECACHE_H
+
+#include <cstdint>
+#include <string>
+#include <map>
+#include <list>
+#include <mutex>
+
+#include "bmp.h"
+
+/*******************************************************************************
+FrameHash
+    64 bit FNV-1a over the raw bytes of the render input, the key of a
+    frame in the FrameCache. Doubles are hashed by their bits, so -0 and 0
+    differ and the keys are only stable on machines with the same byte order
+*******************************************************************************/
+
+class FrameHash{
+private:
+    uint64_t h;
+
+public:
+    FrameHash() : h(14695981039346656037ull) {}
+
+    void add(const void* data, size_t size){
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for(size_t i = 0; i < size; i++){
+            h = (h ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+
+    void add(double value) {add(&value, sizeof(value));}
+    void add(uint64_t value) {add(&value, sizeof(value));}
+    void add(const std::string& s) {add(uint64_t(s.size())); add(s.data(), s.size());}
+
+    uint64_t value() const {return h;}
+};
+
+/*******************************************************************************
+FrameCache class
+    persistent cache of rendered frames, one binary ppm per key in a
+    directory and an index with the size and last use of each. When the
+    files exceed max_bytes the least recently used ones are deleted. An
+    insertion appends its line to the index, later lines of a key win, and
+    the index is rewritten once it holds twice the lines it needs and by
+    the d'tor. Entries whose file is gone and damaged lines are dropped.
+    Can be shared by several renderers and threads
+*******************************************************************************/
+
+class FrameCache{
+public:
+    struct Stats{
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t frames = 0; // in the cache
+        size_t bytes = 0;  // of their files
+    };
+
+private:
+    struct Entry{
+        size_t bytes;
+        uint64_t last_use;
+        std::list<uint64_t>::iterator use;
+    };
+
+    std::string directory;
+    size_t max_bytes;
+
+    std::map<uint64_t, Entry> entries;
+    std::list<uint64_t> lru; // most recent first
+    uint64_t clock;
+    size_t lines; // in the index file
+    Stats counters;
+
+    mutable std::mutex m;
+
+    std::string path(uint64_t key) const;
+    void evict();
+    void save_index();
+    void append_index(uint64_t key, const Entry& entry);
+    void load_index();
+
+public:
+    // the directory is created if needed
+    explicit FrameCache(const std::string& directory, size_t max_bytes = size_t(1) << 30);
+    ~FrameCache();
+
+    FrameCache(const FrameCache&) = delete;
+    FrameCache& operator=(const FrameCache&) = delete;
+
+    // true and the frame in img if key is cached
+    bool get(uint64_t key, bmp::Image& img);
+
+    // stores (or replaces) the frame of key, then evicts down to max_bytes
+    void put(uint64_t key, const bmp::Image& img);
+
+    // deletes every frame
+    void clear();
+
+    // new size bound, applied right away
+    void limit(size_t bytes);
+
+    Stats stats() const;
+};
+
+#endif // FRAMECACHE_H
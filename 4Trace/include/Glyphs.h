@@ -1,34 +1,54 @@
 #ifndef GLYPHS_H
 #define GLYPHS_H
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
 #include "vec.tpp"
 #include "bmp.h"
 
+/*******************************************************************************
+Glyphs class
+    bitmap font of 128 glyphs of 32 x 32 pixels, one bit per pixel. The
+    default font is compiled in (glyph_font.h), so a Glyphs is ready
+    without reading a file; a font bmp with the same layout, 16 x 8
+    glyphs, can be loaded instead, its light pixels are the set bits
+*******************************************************************************/
+
 class Glyphs{
 private:
 
-    bmp::Image base;
     const size_t dimx = 32;
     const size_t dimy = 32;
     const size_t rows = 8;
     const size_t cols = 16;
 
-    std::vector<bmp::Image> images;
+    // dimy rows per glyph, bit i of a row is column i. Points to the
+    // compiled in font or to loaded
+    const uint32_t* font;
+    std::vector<uint32_t> loaded;
 
-    bmp::Image cut_glyph(size_t icol, size_t irow);
+    size_t glyph_index(char c) const;
+    bool pixel(size_t glyph, size_t i, size_t j) const {return font[glyph * dimy + j] >> i & 1;}
 
 public:
     Glyphs();
 
+    // the font in a bmp laid out like bmp_font/bmp_if_font_5.bmp
+    Glyphs(const std::string& font_path);
+
     bmp::Image get_char(char c);
 
-    void imprint(bmp::Image& imp_image, char c, V2<size_t> position, double scale);
+    // imp_image holds the rows [row0, row0 + height) of the picture the
+    // position is in, so a text can be drawn on the strips of a picture
+    // rendered by Renderer::render_strips() one strip at a time
+    void imprint(bmp::Image& imp_image, char c, V2<size_t> position, double scale, size_t row0 = 0);
 
-    void imprint(bmp::Image& imp_image, std::string str, V2<size_t> position, double scale);
+    void imprint(bmp::Image& imp_image, std::string str, V2<size_t> position, double scale, size_t row0 = 0);
 
+    // writes glyph_font.h for the font bmp, run by "4Trace font <bmp> <header>"
+    static void write_header(const std::string& font_path, const std::string& header_path);
 
 };
 
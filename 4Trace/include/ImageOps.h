@@ -0,0 +1,52 @@
+#ifndef IMAGEOPS_H
+#define IMAGEOPS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "bmp.h"
+#include "ThreadPool.h"
+
+/*******************************************************************************
+imgops namespace
+    resizing and compositing of bmp::Image. The pixels of an image are
+    stored column after column (pixelArray(x, y), y from the top), so the
+    loops run down the columns on plain byte arrays, with integer weights
+    and the source indices of every column and row computed once per
+    call. The byte loops are written with SSE2 intrinsics where available
+    and have a scalar tail and fallback. The columns are split in jobs on
+    the pool if one is given. Positions are pixelArray coordinates and
+    may be partly outside the image, only the overlap is touched
+*******************************************************************************/
+
+namespace imgops{
+
+    enum class Filter {bilinear, box};
+
+    // src resampled to the size of dst. box averages the source pixels
+    // under every destination pixel, for downscaling
+    void resize(const bmp::Image& src, bmp::Image& dst, Filter filter = Filter::bilinear, ThreadPool* pool = nullptr);
+
+    bmp::Image resize(const bmp::Image& src, size_t width, size_t height, Filter filter = Filter::bilinear, ThreadPool* pool = nullptr);
+
+    // the box resize fitting in width x height with the aspect ratio of src
+    bmp::Image thumbnail(const bmp::Image& src, size_t width, size_t height, ThreadPool* pool = nullptr);
+
+    // src, then halves of the previous level down to 1 x 1 or levels images
+    std::vector<bmp::Image> mips(const bmp::Image& src, size_t levels = SIZE_MAX, ThreadPool* pool = nullptr);
+
+    // the width x height rectangle of src at (x, y), clipped to src
+    bmp::Image crop(const bmp::Image& src, int x, int y, size_t width, size_t height);
+
+    // copies src at (x, y) of dst
+    void blit(bmp::Image& dst, const bmp::Image& src, int x, int y, ThreadPool* pool = nullptr);
+
+    // src at (x, y) of dst with the constant opacity alpha, 255 is blit()
+    void blend(bmp::Image& dst, const bmp::Image& src, uint8_t alpha, int x, int y, ThreadPool* pool = nullptr);
+
+    // src over dst at (x, y) with one opacity per pixel of src, alpha[x *
+    // height + y] in the order of pixelArray
+    void over(bmp::Image& dst, const bmp::Image& src, const std::vector<uint8_t>& alpha, int x, int y, ThreadPool* pool = nullptr);
+}
+
+#endif // IMAGEOPS_H
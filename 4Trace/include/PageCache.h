@@ -0,0 +1,81 @@
+#ifndef PAGECACHE_H
+#define PAGECACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <list>
+#include <memory>
+#include <fstream>
+#include <unordered_map>
+#include <mutex>
+
+/*******************************************************************************
+PageCache class
+    fixed size pages of a read only file, read on first use and kept up to
+    a memory budget, least recently used first out. The pages are shared
+    pointers, so a page evicted while another thread reads it stays valid
+    until that thread lets it go (it no longer counts as resident). Thread
+    safe, one lock per get(). A fault reads the file outside that lock
+    (pread where there is one) and inserts the page afterwards, so the
+    threads hitting the cache don't wait behind a read
+*******************************************************************************/
+
+class PageCache{
+public:
+    using Page = std::shared_ptr<const std::vector<uint8_t>>;
+
+    struct Stats{
+        size_t hits = 0;
+        size_t faults = 0;     // pages read from the file
+        size_t evictions = 0;
+        size_t bytes_read = 0;
+        size_t resident = 0;   // bytes of the cached pages
+        size_t peak_resident = 0;
+    };
+
+private:
+    struct Entry{
+        Page page;
+        std::list<uint64_t>::iterator use;
+    };
+
+    std::ifstream file;   // without pread, serialized by file_m
+    std::mutex file_m;
+    int fd;               // with pread, -1 otherwise
+    uint64_t file_size;
+    size_t page_bytes;
+    size_t budget;
+
+    std::unordered_map<uint64_t, Entry> pages;
+    std::list<uint64_t> lru; // most recent first
+    Stats counters;
+
+    mutable std::mutex m;
+
+    void evict(size_t keep);
+    void read_at(uint64_t offset, void* data, size_t size);
+
+public:
+    PageCache(const std::string& path, size_t page_bytes, size_t budget);
+    ~PageCache();
+
+    PageCache(const PageCache&) = delete;
+    PageCache& operator=(const PageCache&) = delete;
+
+    size_t page_size() const {return page_bytes;}
+    uint64_t size() const {return file_size;}
+
+    // page number p, [p * page_size(), (p + 1) * page_size()) of the file
+    Page get(uint64_t p);
+
+    // reads bytes outside the cache, for headers and tables
+    void read(uint64_t offset, void* data, size_t size);
+
+    // new budget, applied right away
+    void limit(size_t bytes);
+
+    Stats stats() const;
+};
+
+#endif // PAGECACHE_H
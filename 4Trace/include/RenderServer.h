@@ -0,0 +1,146 @@
+#ifndef RENDERSERVER_H
+#define RENDERSERVER_H
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "Glyphs.h"
+#include "raytracer.tpp"
+
+/*******************************************************************************
+RenderServer class
+    long running render process. Jobs come as text lines from a stream
+    (stdin) or from the clients of a unix domain socket and are rendered by
+    one worker thread, so the thread pools, tile grids, wavefront arenas
+    and the font stay warm between jobs and a job starts right away.
+    Scenes are uploaded once by name and rendered by any number of jobs.
+
+    scene <name> <3|4>           defines (or replaces) a scene, followed by
+        sphere <center> <radius> <material>
+        plane <point> <normal> <material>
+        box <lo> <hi> <material>
+    end                          a material is surface r g b, emission r g b,
+                                 transparency and reflection
+    render <job> <scene> [priority]  queues a job, followed by any of
+        size <width> <height>
+        fov <degrees>
+        position <x y z [w]>
+        turn <a> <b> <degrees>   camera rotation in its plane (a, b)
+        engine recursive|wavefront
+        lights <samples>         see Renderer::light_samples()
+        area <samples>           see Renderer::area_lights()
+        denoise
+        label <x> <y> <scale> <text>
+        output <file>|-[.ext]    file (encoder from the extension) or
+    end                          streamed back, "-" alone is a bmp
+    cancel <job>                 drops a queued job or aborts it
+    status                       queued and running jobs
+    quit                         ends the session
+    shutdown                     ends the session and the server
+
+    Replies are single lines: "queued <job>", "done <job> <ms> <file>",
+    "cancelled <job>", "cancel too late <job>" (the frame is being
+    written), "scene <name>", "status ..." and "error <message>".
+    A streamed frame is the line "frame <job> <ext> <bytes>" followed by
+    the encoded bytes. Higher priorities go first, equal ones in order
+*******************************************************************************/
+
+class RenderServer{
+private:
+    struct SceneEntry{
+        size_t dim;
+        uint64_t version;
+        Scene<3> scene3;
+        Scene<4> scene4;
+    };
+
+    struct Turn{
+        size_t a, b;
+        double degrees;
+    };
+
+    struct Job{
+        std::string name, scene;
+        int priority = 0;
+        uint64_t order = 0;
+
+        unsigned width = 640, height = 480;
+        double fov = 30;
+        std::vector<double> position;
+        std::vector<Turn> turns;
+
+        Engine engine = Engine::recursive;
+        size_t light_samples = 0, area_samples = 0;
+        bool denoise = false;
+
+        std::string label;
+        size_t label_x = 0, label_y = 0;
+        double label_scale = 0.33;
+
+        std::string output = "-";
+
+        // the session that queued it
+        std::ostream* out = nullptr;
+        std::mutex* out_mutex = nullptr;
+    };
+
+    // warm state, only touched by the worker
+    Renderer<3> renderer3;
+    Renderer<4> renderer4;
+    std::string loaded3, loaded4; // scene name and version in the renderers
+    std::unique_ptr<Glyphs> font;
+
+    // shared with the sessions
+    std::mutex m;
+    std::condition_variable cv;
+    std::map<std::string, SceneEntry> scenes;
+    std::vector<Job> queue;
+    std::string running;
+    std::atomic<bool> abort;
+    bool rendered; // the running job is past rendering, a cancel is too late
+    uint64_t next_order;
+    uint64_t next_version;
+    size_t pending; // queued or running
+    bool stop;
+
+    std::thread worker;
+
+    void work();
+
+    template<size_t dim>
+    void render(const Job& job, Renderer<dim>& renderer);
+
+    static void reply(const Job& job, const std::string& line);
+
+    // parse the blocks, the scene is stored and its name returned
+    std::string define_scene(std::istream& in, std::istringstream& args);
+    Job read_job(std::istream& in, std::istringstream& args);
+    static bool read_option(const std::string& line, Job& job); // true on end
+
+public:
+    // nthreads render the tiles of a job
+    explicit RenderServer(size_t nthreads = std::thread::hardware_concurrency());
+    ~RenderServer();
+
+    RenderServer(const RenderServer&) = delete;
+    RenderServer& operator=(const RenderServer&) = delete;
+
+    // reads commands from in until quit, shutdown or the end of the
+    // stream, then waits for the jobs queued by the session. Returns true
+    // on shutdown
+    bool serve(std::istream& in, std::ostream& out);
+
+    // serves the clients of the unix socket at path one after the other,
+    // until one of them sends shutdown
+    void listen(const std::string& path);
+};
+
+#endif // RENDERSERVER_H
@@ -0,0 +1,41 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+#include <cstdint>
+
+/*******************************************************************************
+Sampler class
+    reproducible random numbers for the stochastic parts of the shading.
+    Every thread owns a sampler and restarts it for each pixel from the
+    pixel index and the frame number, so the image doesn't depend on which
+    thread renders which tile. PCG32, no locks and no allocation.
+    The 2D low discrepancy points are the R2 sequence, rotated by a random
+    offset drawn from the pixel stream (Cranley-Patterson), so neighbour
+    pixels use decorrelated point sets
+*******************************************************************************/
+
+class Sampler{
+private:
+    uint64_t seed;
+    uint64_t state;
+    uint64_t increment;
+
+public:
+    explicit Sampler(uint64_t seed = 0);
+
+    // restarts the sequence for a pixel of a frame
+    void start(uint64_t pixel, uint64_t frame = 0);
+
+    uint32_t next_uint();
+
+    // uniform in [0, 1)
+    double next();
+
+    // point n of the R2 sequence in [0, 1)^2 rotated by (du, dv)
+    static void r2(uint64_t n, double du, double dv, double& u, double& v);
+
+    // maps [0, 1)^2 to the unit disk keeping the strata (concentric map)
+    static void disk(double u, double v, double& x, double& y);
+};
+
+#endif // SAMPLER_H
@@ -0,0 +1,69 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+/*******************************************************************************
+ThreadPool class
+    persistent workers that run batches of indexed jobs. The calling thread
+    works on the batch too, so a pool of size 1 has no extra thread and runs
+    everything inline. Jobs are handed out dynamically, one index at a time.
+    Running a batch doesn't allocate. A job that throws stops the batch:
+    the jobs not started are skipped and run() rethrows the first
+    exception once every worker is done
+*******************************************************************************/
+
+class ThreadPool{
+public:
+    // job(context, job index, worker index), worker 0 is the calling thread
+    using Job = void (*)(void*, size_t, size_t);
+
+private:
+    std::vector<std::thread> workers;
+
+    std::mutex m;
+    std::condition_variable cv_start;
+    std::condition_variable cv_done;
+
+    // current batch
+    Job job;
+    void* context;
+    size_t njobs;
+    std::atomic<size_t> next_job;
+    std::exception_ptr error; // first exception of the batch
+
+    size_t active;
+    size_t generation;
+    bool stop;
+
+    void drain(size_t worker);
+    void work(size_t worker);
+
+public:
+    // nthreads is the total number of threads, the caller included
+    explicit ThreadPool(size_t nthreads = 1);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const {return workers.size() + 1;}
+
+    // runs job(context, i, worker) for i in [0, njobs) and waits for it
+    void run(size_t njobs, Job job, void* context);
+
+    // same for a callable f(i, worker)
+    template<typename F>
+    void parallel_for(size_t njobs, F& f){
+        run(njobs, [](void* ctx, size_t i, size_t worker){
+            (*static_cast<F*>(ctx))(i, worker);
+        }, &f);
+    }
+};
+
+#endif // THREADPOOL_H
@@ -0,0 +1,106 @@
+#ifndef TILEFARM_H
+#define TILEFARM_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <functional>
+
+/*******************************************************************************
+farm namespace
+    plumbing of the distributed renderer (distributed.tpp): length prefixed
+    messages over file descriptors and the worker processes. A worker is
+    either a fork of the coordinator or any command reading its messages
+    on stdin and answering on stdout ("ssh host 4Trace worker"), so a frame
+    can use the cores of more than one machine. POSIX only, elsewhere
+    starting workers throws
+*******************************************************************************/
+
+namespace farm{
+
+    using Bytes = std::vector<uint8_t>;
+
+    enum Message : uint32_t {FRAME = 1, TILES, PIXELS, QUIT};
+
+    // appends plain values to a message
+    class Writer{
+    private:
+        Bytes& out;
+
+    public:
+        explicit Writer(Bytes& out) : out(out) {}
+
+        void put(const void* data, size_t size){
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        }
+
+        template<typename T>
+        void put(const T& value) {put(&value, sizeof(T));}
+    };
+
+    // reads them back in the same order, throws past the end
+    class Reader{
+    private:
+        const uint8_t* p;
+        const uint8_t* end;
+
+    public:
+        explicit Reader(const Bytes& in) : p(in.data()), end(in.data() + in.size()) {}
+
+        void get(void* data, size_t size){
+            if(size_t(end - p) < size){
+                throw "farm: truncated message";
+            }
+            std::memcpy(data, p, size);
+            p += size;
+        }
+
+        template<typename T>
+        T get(){
+            T value;
+            get(&value, sizeof(T));
+            return value;
+        }
+    };
+
+    // whole message, false if the other end is gone
+    bool send(int fd, uint32_t type, const Bytes& payload);
+    bool receive(int fd, uint32_t& type, Bytes& payload);
+
+    class Workers{
+    private:
+        std::vector<int> fds;
+        std::vector<int> pids;
+
+        // starts n workers, none if one of them can't be started
+        void spawn(size_t n, const std::function<void(int)>& child);
+        // sends QUIT to the workers and waits for them to exit
+        void stop();
+
+    public:
+        // n forks running body(fd) on their end of a socket pair
+        Workers(size_t n, const std::function<int(int)>& body);
+
+        // n copies of the shell command, with stdin and stdout on the socket
+        Workers(size_t n, const std::string& command);
+
+        ~Workers();
+
+        Workers(const Workers&) = delete;
+        Workers& operator=(const Workers&) = delete;
+
+        size_t size() const {return fds.size();}
+        int fd(size_t worker) const {return fds[worker];}
+
+        // workers with a message to read (or gone), waits for one
+        std::vector<size_t> ready() const;
+
+        // closes the connection of a worker that failed, fd() becomes -1
+        void drop(size_t worker);
+    };
+
+}
+
+#endif // TILEFARM_H
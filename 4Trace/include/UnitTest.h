@@ -8,6 +8,30 @@ public:
     void test_vectors();
     void test_mat();
     void test_bmp();
+    void test_encoders();
+    void test_video_stream();
+    void test_camera();
+    void test_thread_pool();
+    void test_primitives();
+    void test_wavefront();
+    void test_primary_rays();
+    void test_lights();
+    void test_soft_shadows();
+    void test_denoiser();
+    void test_temporal();
+    void test_arena();
+    void test_render_server();
+    void test_frame_cache();
+    void test_distributed();
+    void test_cloud();
+    void test_strips();
+    void test_slices();
+    void test_lod();
+    void test_aux_output();
+    void test_glyphs();
+    void test_image_ops();
+    void test_slice_mode();
+    void test_tile_lists();
 };
 
 
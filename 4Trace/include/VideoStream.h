@@ -0,0 +1,64 @@
+#ifndef VIDEOSTREAM_H
+#define VIDEOSTREAM_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "bmp.h"
+#include "Encoder.h"
+
+/*******************************************************************************
+VideoStream
+    appends rendered frames to a single buffered stream instead of writing
+    one bmp file per frame.
+    Y4M:     self describing 4:4:4 YUV stream, readable by ffmpeg/mpv/x264
+    RAW_RGB: headerless packed rgb24 frames, frame k starts at k*w*h*3,
+             ffmpeg -f rawvideo -pixel_format rgb24 -video_size WxH -i ...
+    the filename "-" streams to stdout, for example
+    4Trace | ffmpeg -i - out.mp4
+    in that case progress messages have to go to stderr
+*******************************************************************************/
+
+namespace enc{
+
+    class VideoStream{
+    public:
+        enum Format {Y4M, RAW_RGB};
+
+    private:
+        std::FILE* file;
+        bool to_stdout;
+        Format format;
+        unsigned fps;
+
+        size_t width;
+        size_t height;
+        size_t nframes;
+
+        // stdio buffer and frame conversion buffer, both reused between frames
+        std::vector<char> io_buffer;
+        Bytes frame;
+
+        void write_header();
+
+    public:
+        // buffer_size is the stdio buffer of the file, unused for stdout
+        VideoStream(std::string filename, Format format, unsigned fps = 25, size_t buffer_size = 1 << 22);
+        ~VideoStream();
+
+        VideoStream(const VideoStream&) = delete;
+        VideoStream& operator=(const VideoStream&) = delete;
+
+        // the first frame fixes the size of the stream
+        void write(const bmp::Image& img);
+
+        // flushes and closes the stream, called by the d'tor
+        void close();
+
+        size_t frames() const {return nframes;}
+    };
+
+}
+
+#endif // VIDEOSTREAM_H
@@ -0,0 +1,121 @@
+#ifndef ANIMATION_T
+#define ANIMATION_T
+
+#include <vector>
+#include <map>
+#include <utility>
+
+#include "vec.tpp"
+#include "camera.tpp"
+
+/*******************************************************************************
+Track class
+    keyframed value, linear interpolation between the keys and clamped
+    before the first and after the last one. T needs T + T and T * double
+*******************************************************************************/
+
+template<typename T>
+class Track{
+    std::vector<std::pair<double, T>> keys; // sorted by time
+
+public:
+    Track() {}
+
+    // adds (or replaces) the key at time t
+    Track& key(double t, const T& value){
+        auto it = keys.begin();
+        while(it != keys.end() && it->first < t){
+            ++it;
+        }
+        if(it != keys.end() && it->first == t){
+            it->second = value;
+        }
+        else{
+            keys.insert(it, std::make_pair(t, value));
+        }
+        return *this;
+    }
+
+    bool empty() const {return keys.empty();}
+
+    T at(double t) const {
+        if(keys.empty()){
+            throw "Track: no keys";
+        }
+        if(t <= keys.front().first) {return keys.front().second;}
+        if(t >= keys.back().first) {return keys.back().second;}
+
+        size_t i = 1;
+        while(keys[i].first < t){
+            i++;
+        }
+
+        const std::pair<double, T>& k0 = keys[i - 1];
+        const std::pair<double, T>& k1 = keys[i];
+
+        double mix = (t - k0.first) / (k1.first - k0.first);
+        return k0.second * (1 - mix) + k1.second * mix;
+    }
+};
+
+/*******************************************************************************
+Animation class
+    interpolates the camera and object parameters over time. The scene is
+    updated in place, so the sphere vector is built once and reused for
+    every frame. Objects are referenced by their index in the scene, S is
+    any sphere type with center, radius and radius2 members
+*******************************************************************************/
+
+template<size_t dim>
+class Animation{
+public:
+    // resolution and fov of the base camera are kept, position, fov and
+    // orientation are overwritten by the tracks that have keys
+    Camera<dim> camera;
+
+    Track<Vector<double, dim>> camera_position;
+    Track<double> camera_fov;
+
+    // the camera is rotated in its own plane (a, b) by angle, in order
+    struct PlaneRotation{
+        size_t a, b;
+        Track<double> angle;
+    };
+    std::vector<PlaneRotation> camera_rotations;
+
+    std::map<size_t, Track<Vector<double, dim>>> centers;
+    std::map<size_t, Track<double>> radii;
+
+    Animation(const Camera<dim>& camera = Camera<dim>()) : camera(camera) {}
+
+    Track<double>& rotation(size_t a, size_t b){
+        camera_rotations.push_back(PlaneRotation{a, b, Track<double>()});
+        return camera_rotations.back().angle;
+    }
+
+    Camera<dim> camera_at(double t) const {
+        Camera<dim> cam = camera;
+        if(!camera_position.empty()) {cam.position = camera_position.at(t);}
+        if(!camera_fov.empty()) {cam.fov = camera_fov.at(t);}
+        for(const PlaneRotation& r : camera_rotations){
+            if(!r.angle.empty()){
+                cam.turn(r.a, r.b, r.angle.at(t));
+            }
+        }
+        return cam;
+    }
+
+    template<typename S>
+    void update(double t, std::vector<S>& scene) const {
+        for(const auto& c : centers){
+            scene.at(c.first).center = c.second.at(t);
+        }
+        for(const auto& r : radii){
+            S& s = scene.at(r.first);
+            s.radius = r.second.at(t);
+            s.radius2 = s.radius * s.radius;
+        }
+    }
+};
+
+#endif // ANIMATION_T
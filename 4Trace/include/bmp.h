@@ -3,6 +3,9 @@
 
 #include <cstdint>
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
 
 #include "mat.tpp"
 #include "vec.tpp"
@@ -61,12 +64,12 @@ namespace bmp{
 
 
     class Image{
-    private:
+    public:
+        // bytes of the headers in the file, also used by headers() and StripWriter
         constexpr static size_t size_file_header = 14;
         constexpr static size_t size_info_header = 40;
         constexpr static size_t size_headers = size_file_header + size_info_header;
 
-    public:
         // public members
         FileHeader file_header;
         InfoHeader info_header;
@@ -83,6 +86,40 @@ namespace bmp{
         void write(std::string filename);
     };
 
+
+    // headers of a width x height image, as Image(width, height) has them
+    void headers(int width, int height, FileHeader& file_header, InfoHeader& info_header);
+
+
+    // writes a bmp file a strip of rows at a time, in the order of the
+    // file: the first strip is the bottom of the image, every strip goes
+    // on top of the previous one. Only one row is buffered, so the image
+    // never has to be in memory. The file is the one Image::write() gives.
+    // Past 4 GiB the size fields are 0, which the format allows
+    class StripWriter{
+    private:
+        std::ofstream file;
+        std::string filename;
+        int width, height;
+        int rows_written;
+        std::vector<char> row;
+
+    public:
+        StripWriter(const std::string& filename, int width, int height);
+
+        // the strip has the width of the image, its last pixel row is
+        // the lowest one
+        void write(Image& strip);
+
+        int rows() const {return rows_written;}
+
+        // throws if the rows don't add up to the height
+        void close();
+
+        // closes and deletes the unfinished file
+        void discard();
+    };
+
 }
 
 
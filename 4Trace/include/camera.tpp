@@ -0,0 +1,99 @@
+#ifndef CAMERA_T
+#define CAMERA_T
+
+#include <cmath>
+
+#include "vec.tpp"
+
+/*******************************************************************************
+Camera class
+    pinhole camera in N dimensions. The orientation is an orthonormal basis
+    stored as world space vectors: axis 0 points right, axis 1 up and axis 2
+    backwards (the camera looks down -axis 2), the remaining axes span the
+    dimensions the image doesn't show. The default camera is the one the
+    renderer always used: origin, looking down -z, 30 deg fov, 640x480
+*******************************************************************************/
+
+template<size_t dim>
+class Camera{
+    static_assert(dim >= 3, "the camera needs at least 3 dimensions");
+
+public:
+    Vector<double, dim> position;
+    Vector<double, dim> axes[dim];
+
+    unsigned width, height;
+    double fov; // vertical field of view in degrees
+
+    // ----------------------------- c'tors -----------------------------------
+    Camera(unsigned width = 640, unsigned height = 480, double fov = 30.) :
+        width(width),
+        height(height),
+        fov(fov)
+    {
+        for(size_t k = 0; k < dim; k++){
+            axes[k][k] = 1;
+        }
+    }
+
+    // ----------------------------- methods ----------------------------------
+
+    Vector<double, dim> right() const {return axes[0];}
+    Vector<double, dim> up() const {return axes[1];}
+    Vector<double, dim> forward() const {return axes[2] * -1.;}
+
+    // rotates the camera in the plane of the world axes a and b, the
+    // rotation is around the world origin only for the orientation, the
+    // position is left alone
+    void rotate(size_t a, size_t b, double deg){
+        double c = cos(radians(deg));
+        double s = sin(radians(deg));
+        for(size_t k = 0; k < dim; k++){
+            double va = axes[k][a];
+            double vb = axes[k][b];
+            axes[k][a] = c * va - s * vb;
+            axes[k][b] = s * va + c * vb;
+        }
+    }
+
+    // rotates the camera in the plane of its own axes a and b,
+    // turn(0, 2, deg) is a yaw, turn(1, 2, deg) a pitch, turn(2, 3, deg)
+    // swings the view direction into the 4th dimension
+    void turn(size_t a, size_t b, double deg){
+        double c = cos(radians(deg));
+        double s = sin(radians(deg));
+        Vector<double, dim> va = axes[a];
+        Vector<double, dim> vb = axes[b];
+        axes[a] = va * c + vb * s;
+        axes[b] = vb * c - va * s;
+    }
+
+    // coordinates of p in the camera frame
+    Vector<double, dim> to_camera(const Vector<double, dim>& p) const {
+        Vector<double, dim> d = p - position;
+        Vector<double, dim> local;
+        for(size_t k = 0; k < dim; k++){
+            local[k] = d.dot(axes[k]);
+        }
+        return local;
+    }
+
+    // tangent of half the fov, the image plane is at distance 1
+    double tan_half_fov() const {return tan(radians(fov) / 2.);}
+
+    // primary rays, unnormalized: the ray through the center of pixel
+    // (i, j), with j counted from the bottom row, is d00 + dx * i + dy * j
+    void ray_deltas(Vector<double, dim>& d00, Vector<double, dim>& dx, Vector<double, dim>& dy) const {
+        double angle = tan_half_fov();
+        double aspect_ratio = width / double(height);
+
+        double sx = angle * aspect_ratio;
+        double sy = angle;
+
+        dx = axes[0] * (2. * sx / width);
+        dy = axes[1] * (2. * sy / height);
+        d00 = axes[0] * (sx * (1. / width - 1.)) + axes[1] * (sy * (1. / height - 1.)) - axes[2];
+    }
+};
+
+#endif // CAMERA_T
@@ -0,0 +1,598 @@
+#ifndef CLOUD_T
+#define CLOUD_T
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <ios>
+
+#include "vec.tpp"
+#include "primitives.tpp"
+#include "PageCache.h"
+#include "FrameCache.h"
+
+/*******************************************************************************
+sphere clouds
+    N-D point clouds of 10^7 - 10^8 spheres, kept on disk and paged in
+    while rendering. The file is page aligned and holds offsets only, so
+    it can be memory mapped as well:
+        page 0      CloudHeader
+        materials   the shared Material table, 8 doubles each
+        nodes       bounding volume hierarchy packed in treelets: a page
+                    holds the top levels of a subtree, so a path from the
+                    root crosses few pages. A node never straddles two
+        spheres     pages of CloudRecords in the order of the leaves, so a
+                    page holds spheres close in space. A page starts with
+                    the CloudFrame its records are quantized in
+    A sphere takes 2 * (dim + 2) bytes: 16 bit coordinates in the frame of
+    its page, a 16 bit radius and its material. The node bounds are those
+    of the quantized spheres, so the hierarchy is exact for what is
+    rendered. SphereCloud reads the nodes and the spheres through a
+    PageCache: the resident memory stays under its budget whatever the
+    size of the file
+*******************************************************************************/
+
+constexpr char CLOUD_MAGIC[8] = "4TCLOUD";
+constexpr uint32_t CLOUD_VERSION = 1;
+constexpr size_t CLOUD_PAGE_SIZE = 1 << 16;
+constexpr uint32_t CLOUD_LEAF = 0x80000000;
+
+struct CloudHeader{
+    char magic[8];
+    uint32_t version;
+    uint32_t dim;
+    uint64_t spheres;
+    uint64_t nodes;
+    uint32_t materials;
+    uint32_t page_size;
+    uint64_t materials_offset;
+    uint64_t nodes_offset;
+    uint64_t spheres_offset;
+    uint64_t fingerprint; // FrameHash of everything after the header
+};
+
+template<size_t dim>
+struct CloudNode{
+    float lo[dim], hi[dim];
+    uint32_t first;  // leaf: first sphere, inner node: first child
+    uint32_t second; // leaf: CLOUD_LEAF | number of spheres, inner node: second child
+
+    bool leaf() const {return second & CLOUD_LEAF;}
+    uint32_t count() const {return second & ~CLOUD_LEAF;}
+};
+
+// center[k] = lo[k] + q[k] * step[k], radius = radius * radius_step
+template<size_t dim>
+struct CloudFrame{
+    float lo[dim];
+    float step[dim];
+    float radius_step;
+};
+
+template<size_t dim>
+struct CloudRecord{
+    uint16_t q[dim];
+    uint16_t radius;
+    uint16_t material;
+};
+
+// input of build_cloud()
+template<size_t dim>
+struct CloudSphere{
+    float center[dim];
+    float radius;
+    uint16_t material;
+};
+
+// where the records are, shared by the writer and the reader
+template<size_t dim>
+struct CloudLayout{
+    CloudHeader header;
+    size_t nodes_per_page;
+    size_t records_per_page;
+
+    explicit CloudLayout(const CloudHeader& h) : header(h) {
+        nodes_per_page = h.page_size / sizeof(CloudNode<dim>);
+        records_per_page = (h.page_size - sizeof(CloudFrame<dim>)) / sizeof(CloudRecord<dim>);
+    }
+
+    uint64_t node_offset(size_t i) const {
+        return header.nodes_offset + (i / nodes_per_page) * header.page_size + (i % nodes_per_page) * sizeof(CloudNode<dim>);
+    }
+
+    uint64_t frame_offset(size_t sphere) const {
+        return header.spheres_offset + (sphere / records_per_page) * header.page_size;
+    }
+
+    uint64_t record_offset(size_t sphere) const {
+        return frame_offset(sphere) + sizeof(CloudFrame<dim>) + (sphere % records_per_page) * sizeof(CloudRecord<dim>);
+    }
+};
+
+template<size_t dim>
+void decode(const CloudFrame<dim>& frame, const CloudRecord<dim>& record, Vector<double, dim>& center, double& radius){
+    for(size_t k = 0; k < dim; k++){
+        center[k] = double(frame.lo[k]) + double(record.q[k]) * double(frame.step[k]);
+    }
+    radius = double(record.radius) * double(frame.radius_step);
+}
+
+// closest float below and above x
+inline float float_down(double x){
+    float f = float(x);
+    return double(f) > x ? std::nextafter(f, -INFINITY) : f;
+}
+
+inline float float_up(double x){
+    float f = float(x);
+    return double(f) < x ? std::nextafter(f, INFINITY) : f;
+}
+
+// slab test of the segment [0, tmax] of the ray against a node, tmin is
+// where the ray enters it
+template<size_t dim>
+bool node_hit(const CloudNode<dim>& node, const Vector<double, dim>& rayorig, const Vector<double, dim>& raydir, double tmax, double& tmin){
+    tmin = 0;
+    for(size_t k = 0; k < dim; k++){
+        // the refracted rays of a total internal reflection are NaN
+        if(std::isnan(raydir[k])) {return false;}
+        if(raydir[k] == 0){
+            if(rayorig[k] < node.lo[k] || rayorig[k] > node.hi[k]) {return false;}
+            continue;
+        }
+        double inv = 1 / raydir[k];
+        double t0 = (node.lo[k] - rayorig[k]) * inv;
+        double t1 = (node.hi[k] - rayorig[k]) * inv;
+        if(t0 > t1) {std::swap(t0, t1);}
+        tmin = std::max(tmin, t0);
+        tmax = std::min(tmax, t1);
+        if(tmin > tmax) {return false;}
+    }
+    return true;
+}
+
+// splits [begin, end) at the median of the longest axis of the centers
+// until a leaf has leaf_size spheres or less, the spheres are reordered.
+// The nodes come in depth first order
+template<size_t dim>
+void cloud_split(std::vector<CloudSphere<dim>>& spheres, size_t begin, size_t end, size_t leaf_size, std::vector<CloudNode<dim>>& nodes){
+    size_t index = nodes.size();
+    nodes.push_back(CloudNode<dim>());
+
+    if(end - begin <= leaf_size){
+        nodes[index].first = begin;
+        nodes[index].second = CLOUD_LEAF | (end - begin);
+        return;
+    }
+
+    float lo[dim], hi[dim];
+    std::fill(lo, lo + dim, INFINITY);
+    std::fill(hi, hi + dim, -INFINITY);
+    for(size_t i = begin; i < end; i++){
+        for(size_t k = 0; k < dim; k++){
+            lo[k] = std::min(lo[k], spheres[i].center[k]);
+            hi[k] = std::max(hi[k], spheres[i].center[k]);
+        }
+    }
+    size_t axis = 0;
+    for(size_t k = 1; k < dim; k++){
+        if(hi[k] - lo[k] > hi[axis] - lo[axis]) {axis = k;}
+    }
+
+    // half of the leaves on each side, so they are full
+    size_t leaves = (end - begin + leaf_size - 1) / leaf_size;
+    size_t mid = begin + leaves / 2 * leaf_size;
+    std::nth_element(spheres.begin() + begin, spheres.begin() + mid, spheres.begin() + end,
+                     [axis](const CloudSphere<dim>& a, const CloudSphere<dim>& b){ return a.center[axis] < b.center[axis]; });
+
+    nodes[index].first = index + 1;
+    cloud_split(spheres, begin, mid, leaf_size, nodes);
+    nodes[index].second = nodes.size();
+    cloud_split(spheres, mid, end, leaf_size, nodes);
+}
+
+// file order of the nodes: pages are filled breadth first from the root
+// of a subtree, the subtrees left over when a page is full are packed
+// the same way, depth first. Returns the old index of every position
+template<size_t dim>
+std::vector<uint32_t> cloud_pack(const std::vector<CloudNode<dim>>& nodes, size_t nodes_per_page){
+    std::vector<uint32_t> order;
+    order.reserve(nodes.size());
+
+    std::vector<uint32_t> roots(1, 0);
+    std::deque<uint32_t> treelet;
+    size_t room = nodes_per_page;
+    while(!roots.empty()){
+        treelet.push_back(roots.back());
+        roots.pop_back();
+
+        while(!treelet.empty()){
+            uint32_t n = treelet.front();
+            treelet.pop_front();
+            order.push_back(n);
+            if(!nodes[n].leaf()){
+                treelet.push_back(nodes[n].first);
+                treelet.push_back(nodes[n].second);
+            }
+
+            if(--room == 0){
+                roots.insert(roots.end(), treelet.rbegin(), treelet.rend());
+                treelet.clear();
+                room = nodes_per_page;
+            }
+        }
+    }
+    return order;
+}
+
+// writes the cloud file of spheres (reordered along the hierarchy) and
+// returns its fingerprint. Spheres need a material of the table
+template<size_t dim>
+uint64_t build_cloud(const std::string& path, std::vector<CloudSphere<dim>>& spheres, const std::vector<Material>& materials,
+                     size_t leaf_size = 8, size_t page_size = CLOUD_PAGE_SIZE){
+    if(materials.size() > 0xFFFF || spheres.size() >= 0xFFFFFFFF){
+        throw "build_cloud: too many spheres or materials";
+    }
+    if(page_size < sizeof(CloudHeader) || page_size < sizeof(CloudFrame<dim>) + sizeof(CloudRecord<dim>) || page_size < sizeof(CloudNode<dim>)){
+        throw "build_cloud: page size too small";
+    }
+    for(const CloudSphere<dim>& s : spheres){
+        if(s.material >= materials.size()){
+            throw "build_cloud: sphere without material";
+        }
+    }
+
+    std::vector<CloudNode<dim>> nodes;
+    if(!spheres.empty()){
+        cloud_split(spheres, 0, spheres.size(), std::max<size_t>(1, leaf_size), nodes);
+    }
+
+    CloudHeader header = {};
+    std::memcpy(header.magic, CLOUD_MAGIC, sizeof(header.magic));
+    header.version = CLOUD_VERSION;
+    header.dim = dim;
+    header.spheres = spheres.size();
+    header.nodes = nodes.size();
+    header.materials = materials.size();
+    header.page_size = page_size;
+
+    auto align = [page_size](uint64_t offset) {return (offset + page_size - 1) / page_size * page_size;};
+    CloudLayout<dim> layout(header);
+    size_t node_pages = (nodes.size() + layout.nodes_per_page - 1) / layout.nodes_per_page;
+    size_t sphere_pages = (spheres.size() + layout.records_per_page - 1) / layout.records_per_page;
+    header.materials_offset = page_size;
+    header.nodes_offset = align(header.materials_offset + materials.size() * 8 * sizeof(double));
+    header.spheres_offset = header.nodes_offset + node_pages * page_size;
+    layout = CloudLayout<dim>(header);
+
+    // quantization, one frame per page of records
+    std::vector<CloudFrame<dim>> frames(sphere_pages);
+    std::vector<CloudRecord<dim>> records(spheres.size());
+    for(size_t p = 0; p < sphere_pages; p++){
+        size_t begin = p * layout.records_per_page;
+        size_t end = std::min(spheres.size(), begin + layout.records_per_page);
+
+        double lo[dim], hi[dim], rmax = 0;
+        std::fill(lo, lo + dim, INFINITY);
+        std::fill(hi, hi + dim, -INFINITY);
+        for(size_t i = begin; i < end; i++){
+            for(size_t k = 0; k < dim; k++){
+                lo[k] = std::min(lo[k], double(spheres[i].center[k]));
+                hi[k] = std::max(hi[k], double(spheres[i].center[k]));
+            }
+            rmax = std::max(rmax, double(spheres[i].radius));
+        }
+
+        CloudFrame<dim>& frame = frames[p];
+        for(size_t k = 0; k < dim; k++){
+            frame.lo[k] = float_down(lo[k]);
+            frame.step[k] = float_up((hi[k] - frame.lo[k]) / 0xFFFF);
+        }
+        frame.radius_step = float_up(rmax / 0xFFFF);
+
+        for(size_t i = begin; i < end; i++){
+            for(size_t k = 0; k < dim; k++){
+                double q = frame.step[k] > 0 ? std::round((spheres[i].center[k] - frame.lo[k]) / frame.step[k]) : 0;
+                records[i].q[k] = uint16_t(std::min(std::max(q, 0.), double(0xFFFF)));
+            }
+            double r = frame.radius_step > 0 ? std::round(spheres[i].radius / frame.radius_step) : 0;
+            records[i].radius = uint16_t(std::min(r, double(0xFFFF)));
+            records[i].material = spheres[i].material;
+        }
+    }
+
+    // bounds of the decoded spheres, the children of a node come after it
+    for(size_t n = nodes.size(); n-- > 0;){
+        CloudNode<dim>& node = nodes[n];
+        std::fill(node.lo, node.lo + dim, INFINITY);
+        std::fill(node.hi, node.hi + dim, -INFINITY);
+        if(node.leaf()){
+            for(size_t i = node.first; i < node.first + node.count(); i++){
+                Vector<double, dim> center;
+                double radius;
+                decode(frames[i / layout.records_per_page], records[i], center, radius);
+                for(size_t k = 0; k < dim; k++){
+                    node.lo[k] = std::min(node.lo[k], float_down(center[k] - radius));
+                    node.hi[k] = std::max(node.hi[k], float_up(center[k] + radius));
+                }
+            }
+        }
+        else{
+            const CloudNode<dim>& a = nodes[node.first];
+            const CloudNode<dim>& b = nodes[node.second];
+            for(size_t k = 0; k < dim; k++){
+                node.lo[k] = std::min(a.lo[k], b.lo[k]);
+                node.hi[k] = std::max(a.hi[k], b.hi[k]);
+            }
+        }
+    }
+
+    if(!nodes.empty()){
+        std::vector<uint32_t> order = cloud_pack(nodes, layout.nodes_per_page);
+        std::vector<uint32_t> position(nodes.size());
+        for(size_t n = 0; n < order.size(); n++){
+            position[order[n]] = n;
+        }
+        std::vector<CloudNode<dim>> packed(nodes.size());
+        for(size_t n = 0; n < order.size(); n++){
+            packed[n] = nodes[order[n]];
+            if(!packed[n].leaf()){
+                packed[n].first = position[packed[n].first];
+                packed[n].second = position[packed[n].second];
+            }
+        }
+        nodes.swap(packed);
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if(!out){
+        throw std::ios_base::failure("build_cloud: opening " + path + " went wrong");
+    }
+
+    FrameHash hash;
+    uint64_t position = page_size;
+    std::vector<char> zeros(page_size, 0);
+    auto write = [&](const void* data, size_t size){
+        out.write(static_cast<const char*>(data), size);
+        hash.add(data, size);
+        position += size;
+    };
+    auto pad = [&](uint64_t offset){
+        write(zeros.data(), offset - position);
+    };
+
+    out.write(zeros.data(), page_size);
+    for(const Material& m : materials){
+        double fields[8] = {m.surface[0], m.surface[1], m.surface[2], m.emission[0], m.emission[1], m.emission[2],
+                            m.transparency, m.reflection};
+        write(fields, sizeof(fields));
+    }
+    for(size_t n = 0; n < nodes.size(); n++){
+        pad(layout.node_offset(n));
+        write(&nodes[n], sizeof(CloudNode<dim>));
+    }
+    for(size_t i = 0; i < spheres.size(); i++){
+        if(i % layout.records_per_page == 0){
+            pad(layout.frame_offset(i));
+            write(&frames[i / layout.records_per_page], sizeof(CloudFrame<dim>));
+        }
+        write(&records[i], sizeof(CloudRecord<dim>));
+    }
+
+    header.fingerprint = hash.value();
+    out.seekp(0);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if(!out){
+        throw std::ios_base::failure("build_cloud: writing " + path + " went wrong");
+    }
+    return header.fingerprint;
+}
+
+/*******************************************************************************
+SphereCloud class
+    a cloud file opened for rendering, set as Scene::cloud. Hits on its
+    spheres are Shape::cloud with the index of the sphere in the file.
+    Only the header and the material table stay in memory, the nodes and
+    the spheres are read through a PageCache of budget bytes. The clouds
+    aren't lights and aren't in the tile candidate lists: every ray walks
+    the hierarchy. Thread safe
+*******************************************************************************/
+
+template<size_t dim>
+class SphereCloud{
+private:
+    // the page a thread is reading, kept for the next record
+    struct Cursor{
+        uint64_t page = std::numeric_limits<uint64_t>::max();
+        PageCache::Page data;
+    };
+
+    CloudHeader header;
+    std::unique_ptr<CloudLayout<dim>> layout;
+    std::vector<Material> table;
+    std::unique_ptr<PageCache> pages;
+
+    const uint8_t* at(uint64_t offset, Cursor& cursor) const {
+        uint64_t p = offset / header.page_size;
+        if(p != cursor.page){
+            cursor.data = pages->get(p);
+            cursor.page = p;
+        }
+        return cursor.data->data() + offset % header.page_size;
+    }
+
+    CloudNode<dim> node(size_t i, Cursor& cursor) const {
+        CloudNode<dim> n;
+        std::memcpy(&n, at(layout->node_offset(i), cursor), sizeof(n));
+        return n;
+    }
+
+    CloudRecord<dim> record(size_t i, Cursor& cursor, Vector<double, dim>& center, double& radius) const {
+        CloudFrame<dim> frame;
+        CloudRecord<dim> r;
+        std::memcpy(&frame, at(layout->frame_offset(i), cursor), sizeof(frame));
+        std::memcpy(&r, at(layout->record_offset(i), cursor), sizeof(r));
+        decode(frame, r, center, radius);
+        return r;
+    }
+
+public:
+    explicit SphereCloud(const std::string& path, size_t budget = size_t(256) << 20){
+        std::ifstream in(path, std::ios::binary);
+        if(!in.read(reinterpret_cast<char*>(&header), sizeof(header))){
+            throw std::ios_base::failure("SphereCloud: reading " + path + " went wrong");
+        }
+        if(std::memcmp(header.magic, CLOUD_MAGIC, sizeof(header.magic)) != 0 || header.version != CLOUD_VERSION){
+            throw std::ios_base::failure("SphereCloud: " + path + " isn't a sphere cloud");
+        }
+        if(header.dim != dim){
+            throw std::ios_base::failure("SphereCloud: " + path + " has another dimension");
+        }
+        layout.reset(new CloudLayout<dim>(header));
+        pages.reset(new PageCache(path, header.page_size, budget));
+
+        std::vector<double> fields(8 * header.materials);
+        pages->read(header.materials_offset, fields.data(), fields.size() * sizeof(double));
+        for(size_t m = 0; m < header.materials; m++){
+            const double* f = &fields[8 * m];
+            table.push_back(Material(Color(f[0], f[1], f[2]), Color(f[3], f[4], f[5]), f[6], f[7]));
+        }
+    }
+
+    size_t size() const {return header.spheres;}
+    size_t nodes() const {return header.nodes;}
+    const std::vector<Material>& materials() const {return table;}
+
+    // changes with the content of the file, part of the FrameCache keys
+    uint64_t fingerprint() const {return header.fingerprint;}
+
+    PageCache::Stats stats() const {return pages->stats();}
+    void limit(size_t budget) {pages->limit(budget);}
+
+    Sphere<dim> sphere(size_t i) const {
+        Cursor cursor;
+        Vector<double, dim> center;
+        double radius;
+        const Material& m = table[record(i, cursor, center, radius).material];
+        return Sphere<dim>(center, radius, m.surface, m.emission, m.transparency, m.reflection);
+    }
+
+    const Material& material(size_t i) const {
+        Cursor cursor;
+        Vector<double, dim> center;
+        double radius;
+        return table[record(i, cursor, center, radius).material];
+    }
+
+    // closest sphere closer than hit.t, same test as closest_hit(). The
+    // nearer child is visited first
+    bool intersect(const Vector<double, dim>& rayorig, const Vector<double, dim>& raydir, Hit& hit) const {
+        if(header.nodes == 0) {return false;}
+
+        Cursor nodes_at, spheres_at;
+        uint32_t stack[64];
+        double entry[64];
+        size_t top = 0;
+        bool found = false;
+
+        double t;
+        if(node_hit(node(0, nodes_at), rayorig, raydir, hit.t, t)){
+            stack[top] = 0;
+            entry[top++] = t;
+        }
+
+        while(top > 0){
+            top--;
+            if(entry[top] > hit.t) {continue;}
+            CloudNode<dim> n = node(stack[top], nodes_at);
+
+            if(!n.leaf()){
+                double ta, tb;
+                bool a = node_hit(node(n.first, nodes_at), rayorig, raydir, hit.t, ta);
+                bool b = node_hit(node(n.second, nodes_at), rayorig, raydir, hit.t, tb);
+                if(a && b && ta < tb){
+                    stack[top] = n.second;
+                    entry[top++] = tb;
+                    b = false;
+                }
+                if(a){
+                    stack[top] = n.first;
+                    entry[top++] = ta;
+                }
+                if(b){
+                    stack[top] = n.second;
+                    entry[top++] = tb;
+                }
+                continue;
+            }
+
+            for(uint32_t s = n.first; s < n.first + n.count(); s++){
+                Vector<double, dim> center;
+                double radius;
+                record(s, spheres_at, center, radius);
+
+                Vector<double, dim> l = center - rayorig;
+                double tca = l.dot(raydir);
+                if(tca < 0) {continue;}
+                double d2 = l.dot(l) - tca * tca;
+                if(d2 > radius * radius) {continue;}
+
+                double thc = sqrt(radius * radius - d2);
+                double t0 = tca - thc;
+                if(t0 < 0) t0 = tca + thc;
+                if(t0 < hit.t){
+                    hit.t = t0;
+                    hit.shape = Shape::cloud;
+                    hit.index = s;
+                    found = true;
+                }
+            }
+        }
+        return found;
+    }
+
+    // true if a sphere is on the ray closer than tmax, same test as occluded()
+    bool occluded(const Vector<double, dim>& rayorig, const Vector<double, dim>& raydir, double tmax) const {
+        if(header.nodes == 0) {return false;}
+
+        Cursor nodes_at, spheres_at;
+        uint32_t stack[64];
+        size_t top = 0;
+        stack[top++] = 0;
+
+        while(top > 0){
+            double t;
+            CloudNode<dim> n = node(stack[--top], nodes_at);
+            if(!node_hit(n, rayorig, raydir, tmax, t)) {continue;}
+
+            if(!n.leaf()){
+                stack[top++] = n.second;
+                stack[top++] = n.first;
+                continue;
+            }
+
+            for(uint32_t s = n.first; s < n.first + n.count(); s++){
+                Vector<double, dim> center;
+                double radius;
+                record(s, spheres_at, center, radius);
+
+                Vector<double, dim> l = center - rayorig;
+                double tca = l.dot(raydir);
+                if(tca < 0) {continue;}
+                double d2 = l.dot(l) - tca * tca;
+                if(d2 <= radius * radius && tca - sqrt(radius * radius - d2) < tmax){
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+};
+
+#endif // CLOUD_T
@@ -0,0 +1,535 @@
+#ifndef DISTRIBUTED_T
+#define DISTRIBUTED_T
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <string>
+#include <algorithm>
+
+#include "raytracer.tpp"
+#include "TileFarm.h"
+
+/*******************************************************************************
+distributed rendering
+    one frame split over worker processes. The coordinator sends the
+    scene, camera and settings of the frame to every worker, then hands
+    out work units (lists of tiles) on demand, two in flight per worker,
+    and copies the returned pixels in its image. The units are sized from
+    the tile candidate lists: a tile costs one plus its objects, mirrors
+    and glass eight, cheap tiles are grouped and expensive ones go alone,
+    the most expensive first, so the slow glass tiles are spread over the
+    workers and the cheap ones fill the end of the frame. The units of a
+    worker that dies are given to the others. The workers render with the
+    same frame number, so the image is the one of Renderer::render().
+    The aux buffers, the temporal accumulation and the denoiser need the
+    whole frame and aren't available
+*******************************************************************************/
+
+namespace farm{
+
+    template<size_t dim>
+    void put_vector(Writer& out, const Vector<double, dim>& v){
+        for(size_t k = 0; k < dim; k++){
+            out.put(v[k]);
+        }
+    }
+
+    template<size_t dim>
+    Vector<double, dim> get_vector(Reader& in){
+        Vector<double, dim> v;
+        for(size_t k = 0; k < dim; k++){
+            v[k] = in.get<double>();
+        }
+        return v;
+    }
+
+    inline void put_material(Writer& out, const Material& m){
+        for(size_t c = 0; c < 3; c++){
+            out.put(m.surface[c]);
+            out.put(m.emission[c]);
+        }
+        out.put(m.transparency);
+        out.put(m.reflection);
+    }
+
+    inline void get_material(Reader& in, Material& m){
+        for(size_t c = 0; c < 3; c++){
+            m.surface[c] = in.get<double>();
+            m.emission[c] = in.get<double>();
+        }
+        m.transparency = in.get<double>();
+        m.reflection = in.get<double>();
+    }
+
+    template<size_t dim>
+    void put_scene(Writer& out, const Scene<dim>& scene){
+        if(scene.cloud){
+            throw "farm: sphere clouds can't be sent to the workers";
+        }
+        out.put(uint64_t(scene.spheres.size()));
+        for(const Sphere<dim>& s : scene.spheres){
+            put_vector(out, s.center);
+            out.put(s.radius);
+            put_material(out, s);
+        }
+        out.put(uint64_t(scene.planes.size()));
+        for(const Plane<dim>& p : scene.planes){
+            put_vector(out, p.n);
+            out.put(p.offset);
+            put_material(out, p);
+        }
+        out.put(uint64_t(scene.boxes.size()));
+        for(const Box<dim>& b : scene.boxes){
+            put_vector(out, b.lo);
+            put_vector(out, b.hi);
+            put_material(out, b);
+        }
+    }
+
+    // the planes are copied bit for bit, not rebuilt from a point
+    template<size_t dim>
+    void get_scene(Reader& in, Scene<dim>& scene){
+        scene.clear();
+        Color black(0);
+        Vector<double, dim> zero;
+
+        for(uint64_t n = in.get<uint64_t>(); n > 0; n--){
+            Vector<double, dim> center = get_vector<dim>(in);
+            double radius = in.get<double>();
+            scene.spheres.push_back(Sphere<dim>(center, radius, black, black, 0, 0));
+            get_material(in, scene.spheres.back());
+        }
+        for(uint64_t n = in.get<uint64_t>(); n > 0; n--){
+            Vector<double, dim> normal = get_vector<dim>(in);
+            scene.planes.push_back(Plane<dim>(zero, normal, black, black, 0, 0));
+            scene.planes.back().n = normal;
+            scene.planes.back().offset = in.get<double>();
+            get_material(in, scene.planes.back());
+        }
+        for(uint64_t n = in.get<uint64_t>(); n > 0; n--){
+            Vector<double, dim> lo = get_vector<dim>(in);
+            Vector<double, dim> hi = get_vector<dim>(in);
+            scene.boxes.push_back(Box<dim>(lo, hi, black, black, 0, 0));
+            get_material(in, scene.boxes.back());
+        }
+    }
+
+    template<size_t dim>
+    void put_camera(Writer& out, const Camera<dim>& camera){
+        put_vector(out, camera.position);
+        for(size_t k = 0; k < dim; k++){
+            put_vector(out, camera.axes[k]);
+        }
+        out.put(uint32_t(camera.width));
+        out.put(uint32_t(camera.height));
+        out.put(camera.fov);
+    }
+
+    template<size_t dim>
+    void get_camera(Reader& in, Camera<dim>& camera){
+        camera.position = get_vector<dim>(in);
+        for(size_t k = 0; k < dim; k++){
+            camera.axes[k] = get_vector<dim>(in);
+        }
+        camera.width = in.get<uint32_t>();
+        camera.height = in.get<uint32_t>();
+        camera.fov = in.get<double>();
+    }
+
+    // settings of a frame, sent with the scene
+    struct FrameSettings{
+        uint64_t threads = 1;
+        uint32_t engine = 0;
+        uint64_t light_samples = 0;
+        uint64_t area_samples = 0;
+        uint64_t area_max_samples = 0;
+        uint64_t frame_number = 0;
+        double lod_pixels = 0;
+    };
+
+    inline void put_settings(Writer& out, const FrameSettings& settings){
+        out.put(settings.threads);
+        out.put(settings.engine);
+        out.put(settings.light_samples);
+        out.put(settings.area_samples);
+        out.put(settings.area_max_samples);
+        out.put(settings.frame_number);
+        out.put(settings.lod_pixels);
+    }
+
+    inline void get_settings(Reader& in, FrameSettings& settings){
+        settings.threads = in.get<uint64_t>();
+        settings.engine = in.get<uint32_t>();
+        settings.light_samples = in.get<uint64_t>();
+        settings.area_samples = in.get<uint64_t>();
+        settings.area_max_samples = in.get<uint64_t>();
+        settings.frame_number = in.get<uint64_t>();
+        settings.lod_pixels = in.get<double>();
+    }
+
+    // pixel rectangle of a tile, rows j from the bottom
+    inline void tile_rect(const TileGrid& grid, size_t tile, size_t width, size_t height,
+                          size_t& i0, size_t& i1, size_t& j0, size_t& j1){
+        size_t tx = grid.tile_x(tile);
+        size_t ty = grid.tile_y(tile);
+        i0 = tx * TILE_SIZE;
+        i1 = std::min(width, i0 + TILE_SIZE);
+        j0 = ty * TILE_SIZE;
+        j1 = std::min(height, j0 + TILE_SIZE);
+    }
+
+    template<size_t dim>
+    void start_frame(Reader& in, const FrameSettings& settings, std::unique_ptr<Renderer<dim>>& renderer){
+        if(!renderer || renderer->threads() != settings.threads){
+            renderer.reset(new Renderer<dim>(Camera<dim>(), settings.threads));
+        }
+        get_camera(in, renderer->camera());
+        get_scene(in, renderer->scene());
+        renderer->engine(Engine(settings.engine));
+        renderer->light_samples(settings.light_samples);
+        renderer->area_lights(settings.area_samples, settings.area_max_samples);
+        renderer->frame_index(settings.frame_number);
+        renderer->level_of_detail(settings.lod_pixels);
+        renderer->begin_frame();
+    }
+
+    // renders the tiles of the unit, the reply has the unit id and the
+    // pixels of the tiles in order, rgb row by row from the bottom. False
+    // if a tile id is not in the grid of the renderer
+    template<size_t dim>
+    bool render_unit(Renderer<dim>& renderer, uint32_t unit, const std::vector<uint32_t>& tiles, Bytes& reply){
+        for(uint32_t tile : tiles){
+            if(tile >= renderer.tiles().tiles.size()){
+                return false;
+            }
+        }
+        renderer.render_tiles(tiles.data(), tiles.size());
+
+        const bmp::Image& img = renderer.image();
+        size_t width = renderer.camera().width, height = renderer.camera().height;
+
+        reply.clear();
+        Writer out(reply);
+        out.put(unit);
+        for(uint32_t tile : tiles){
+            size_t i0, i1, j0, j1;
+            tile_rect(renderer.tiles(), tile, width, height, i0, i1, j0, j1);
+            for(size_t j = j0; j < j1; j++){
+                for(size_t i = i0; i < i1; i++){
+                    bmp::Color c = img.pixelArray.get(i, height - 1 - j);
+                    uint8_t rgb[3] = {c.x(), c.y(), c.z()};
+                    out.put(rgb, 3);
+                }
+            }
+        }
+        return true;
+    }
+
+}
+
+// body of a worker process: answers the messages of a coordinator read
+// on in, until QUIT or the end of the input. "4Trace worker" runs it on
+// stdin and stdout
+inline int tile_worker(int in, int out){
+    std::unique_ptr<Renderer<3>> renderer3;
+    std::unique_ptr<Renderer<4>> renderer4;
+    uint64_t dim = 0;
+
+    uint32_t type;
+    farm::Bytes message, reply;
+    std::vector<uint32_t> tiles;
+
+    while(farm::receive(in, type, message) && type != farm::QUIT){
+        farm::Reader reader(message);
+
+        if(type == farm::FRAME){
+            dim = reader.get<uint64_t>();
+            farm::FrameSettings settings;
+            farm::get_settings(reader, settings);
+            if(dim == 3){
+                farm::start_frame(reader, settings, renderer3);
+            }
+            else if(dim == 4){
+                farm::start_frame(reader, settings, renderer4);
+            }
+            else{
+                return 1;
+            }
+        }
+        else if(type == farm::TILES){
+            uint32_t unit = reader.get<uint32_t>();
+            tiles.resize(reader.get<uint32_t>());
+            for(uint32_t& t : tiles){
+                t = reader.get<uint32_t>();
+            }
+
+            bool rendered = false;
+            if(dim == 3){
+                rendered = farm::render_unit(*renderer3, unit, tiles, reply);
+            }
+            else if(dim == 4){
+                rendered = farm::render_unit(*renderer4, unit, tiles, reply);
+            }
+            if(!rendered || !farm::send(out, farm::PIXELS, reply)){
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/*******************************************************************************
+DistributedRenderer class
+    the interface of Renderer for the distributed frames. The scene,
+    camera and settings live in a local Renderer, which only builds the
+    tile grid and holds the assembled image
+*******************************************************************************/
+
+template<size_t dim>
+class DistributedRenderer{
+private:
+    farm::Workers workers;
+    size_t worker_threads;
+    Renderer<dim> local;
+
+    // tiles of every unit and their estimated cost
+    std::vector<std::vector<uint32_t>> units;
+    std::vector<size_t> unit_cost;
+    std::vector<size_t> tiles_by_worker;
+
+    size_t tile_cost(const Tile& tile) const {
+        const Scene<dim>& scene = local.traced();
+        size_t cost = 1 + scene.planes.size();
+        for(size_t i : tile.spheres){
+            const Sphere<dim>& s = scene.spheres[i];
+            cost += (s.transparency > 0 || s.reflection > 0) ? 8 : 1;
+        }
+        for(size_t i : tile.boxes){
+            const Box<dim>& b = scene.boxes[i];
+            cost += (b.transparency > 0 || b.reflection > 0) ? 8 : 1;
+        }
+        return cost;
+    }
+
+    // about 8 units per worker, most expensive first
+    void build_units(size_t nworkers){
+        const TileGrid& grid = local.tiles();
+        std::vector<size_t> cost(grid.tiles.size());
+        size_t total = 0;
+        for(size_t t = 0; t < grid.tiles.size(); t++){
+            cost[t] = tile_cost(grid.tiles[t]);
+            total += cost[t];
+        }
+        size_t target = std::max<size_t>(1, total / (8 * nworkers));
+
+        std::vector<std::vector<uint32_t>> grouped;
+        std::vector<size_t> grouped_cost;
+        std::vector<uint32_t> current;
+        size_t current_cost = 0;
+        for(size_t t = 0; t < grid.tiles.size(); t++){
+            if(cost[t] >= target){
+                grouped.push_back(std::vector<uint32_t>(1, t));
+                grouped_cost.push_back(cost[t]);
+                continue;
+            }
+            current.push_back(t);
+            current_cost += cost[t];
+            if(current_cost >= target){
+                grouped.push_back(current);
+                grouped_cost.push_back(current_cost);
+                current.clear();
+                current_cost = 0;
+            }
+        }
+        if(!current.empty()){
+            grouped.push_back(current);
+            grouped_cost.push_back(current_cost);
+        }
+
+        std::vector<size_t> order(grouped.size());
+        for(size_t u = 0; u < order.size(); u++){
+            order[u] = u;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b){ return grouped_cost[a] > grouped_cost[b]; });
+
+        units.clear();
+        unit_cost.clear();
+        for(size_t u : order){
+            units.push_back(grouped[u]);
+            unit_cost.push_back(grouped_cost[u]);
+        }
+    }
+
+    bool send_unit(size_t worker, uint32_t unit){
+        farm::Bytes message;
+        farm::Writer out(message);
+        out.put(unit);
+        out.put(uint32_t(units[unit].size()));
+        for(uint32_t t : units[unit]){
+            out.put(t);
+        }
+        return farm::send(workers.fd(worker), farm::TILES, message);
+    }
+
+    // copies the pixels of a PIXELS reply in the image, returns the unit
+    uint32_t store_unit(const farm::Bytes& message){
+        farm::Reader in(message);
+        uint32_t unit = in.get<uint32_t>();
+        if(unit >= units.size()){
+            throw "DistributedRenderer: unknown unit";
+        }
+
+        bmp::Image& img = local.image();
+        size_t width = local.camera().width, height = local.camera().height;
+        for(uint32_t tile : units[unit]){
+            size_t i0, i1, j0, j1;
+            farm::tile_rect(local.tiles(), tile, width, height, i0, i1, j0, j1);
+            for(size_t j = j0; j < j1; j++){
+                for(size_t i = i0; i < i1; i++){
+                    uint8_t rgb[3];
+                    in.get(rgb, 3);
+                    img.pixelArray.set(i, height - 1 - j, bmp::Color(rgb[0], rgb[1], rgb[2]));
+                }
+            }
+        }
+        return unit;
+    }
+
+public:
+    // nworkers forked processes with worker_threads threads each
+    DistributedRenderer(const Camera<dim>& camera, size_t nworkers, size_t worker_threads = 1, Engine engine = Engine::recursive) :
+        workers(nworkers, [](int fd){ return tile_worker(fd, fd); }),
+        worker_threads(worker_threads),
+        local(camera, 1, engine)
+        {}
+
+    // nworkers copies of a shell command running tile_worker() on its
+    // stdin and stdout, like "ssh host ./4Trace worker"
+    DistributedRenderer(const Camera<dim>& camera, size_t nworkers, const std::string& command, size_t worker_threads = 1, Engine engine = Engine::recursive) :
+        workers(nworkers, command),
+        worker_threads(worker_threads),
+        local(camera, 1, engine)
+        {}
+
+    Scene<dim>& scene() {return local.scene();}
+    Camera<dim>& camera() {return local.camera();}
+
+    Engine engine() const {return local.engine();}
+    void engine(Engine e) {local.engine(e);}
+
+    void light_samples(size_t n) {local.light_samples(n);}
+    void level_of_detail(double pixels) {local.level_of_detail(pixels);}
+
+    void area_lights(size_t samples, size_t max_samples = 0) {local.area_lights(samples, max_samples);}
+
+    size_t workers_alive() const {
+        size_t n = 0;
+        for(size_t w = 0; w < workers.size(); w++){
+            n += workers.fd(w) >= 0;
+        }
+        return n;
+    }
+
+    // work units of the last frame and the tiles rendered by each worker
+    size_t work_units() const {return units.size();}
+    const std::vector<size_t>& worker_tiles() const {return tiles_by_worker;}
+
+    bmp::Image& image() {return local.image();}
+
+    bmp::Image& render(){
+        local.begin_frame();
+
+        farm::Bytes message;
+        farm::Writer out(message);
+        farm::FrameSettings settings;
+        settings.threads = worker_threads;
+        settings.engine = uint32_t(local.engine());
+        settings.light_samples = local.light_samples();
+        settings.area_samples = local.area_samples();
+        settings.area_max_samples = local.area_max_samples();
+        settings.frame_number = local.frame_index();
+        settings.lod_pixels = local.level_of_detail();
+        out.put(uint64_t(dim));
+        farm::put_settings(out, settings);
+        farm::put_camera(out, local.camera());
+        farm::put_scene(out, local.scene());
+
+        for(size_t w = 0; w < workers.size(); w++){
+            if(workers.fd(w) >= 0 && !farm::send(workers.fd(w), farm::FRAME, message)){
+                workers.drop(w);
+            }
+        }
+
+        build_units(std::max<size_t>(1, workers_alive()));
+        tiles_by_worker.assign(workers.size(), 0);
+
+        std::deque<uint32_t> queue;
+        for(uint32_t u = 0; u < units.size(); u++){
+            queue.push_back(u);
+        }
+        std::vector<std::vector<uint32_t>> in_flight(workers.size());
+        size_t done = 0;
+
+        // up to two units per worker, the second hides the round trip
+        auto dispatch = [&](){
+            for(size_t w = 0; w < workers.size(); w++){
+                while(workers.fd(w) >= 0 && in_flight[w].size() < 2 && !queue.empty()){
+                    uint32_t u = queue.front();
+                    if(!send_unit(w, u)){
+                        workers.drop(w);
+                        break;
+                    }
+                    queue.pop_front();
+                    in_flight[w].push_back(u);
+                }
+                if(workers.fd(w) < 0){
+                    // a dead worker gives its units back
+                    queue.insert(queue.begin(), in_flight[w].begin(), in_flight[w].end());
+                    in_flight[w].clear();
+                }
+            }
+        };
+
+        uint32_t type;
+        farm::Bytes reply;
+        while(done < units.size()){
+            dispatch();
+            if(workers_alive() == 0){
+                throw "DistributedRenderer: no worker left";
+            }
+
+            for(size_t w : workers.ready()){
+                if(!farm::receive(workers.fd(w), type, reply) || type != farm::PIXELS){
+                    workers.drop(w);
+                    continue;
+                }
+                // a unit the worker was not given, or short of pixels, is a
+                // protocol error, its units go back to the queue
+                std::vector<uint32_t>::iterator it = in_flight[w].end();
+                if(reply.size() >= sizeof(uint32_t)){
+                    it = std::find(in_flight[w].begin(), in_flight[w].end(), farm::Reader(reply).get<uint32_t>());
+                }
+                if(it == in_flight[w].end()){
+                    workers.drop(w);
+                    continue;
+                }
+                try{
+                    store_unit(reply);
+                }
+                catch(const char*){
+                    workers.drop(w);
+                    continue;
+                }
+                tiles_by_worker[w] += units[*it].size();
+                in_flight[w].erase(it);
+                done++;
+            }
+        }
+
+        local.frame_index(local.frame_index() + 1);
+        return local.image();
+    }
+};
+
+#endif // DISTRIBUTED_T
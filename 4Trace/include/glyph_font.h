@@ -0,0 +1,779 @@
+#ifndef GLYPH_FONT_H
+#define GLYPH_FONT_H
+
+#include <cstdint>
+
+// generated from bmp_font/bmp_if_font_5.bmp by Glyphs::write_header(),
+// 128 glyphs of 32 rows, bit i of a row is column i
+constexpr uint32_t GLYPH_FONT[128][32] = {
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00,
+        0x00fffff0, 0x00fffff0, 0x00fffff0, 0x00fffff0, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00,
+        0x00fffff0, 0x00fffff0, 0x00fffff0, 0x00fffff0, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x0ffff000, 0x0ffff000, 0x0ffff000, 0x0ffff000,
+        0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000,
+        0x0f0f0000, 0x0f0f0000, 0x0f0f0000, 0x0f0f0000, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000ff0, 0x00000ff0, 0x00000ff0, 0x00000ff0, 0x00f0f00f, 0x00f0f00f, 0x00f0f00f, 0x00f0f00f,
+        0x000f0ff0, 0x000f0ff0, 0x000f0ff0, 0x000f0ff0, 0x0ff0f000, 0x0ff0f000, 0x0ff0f000, 0x0ff0f000,
+        0xf00f0f00, 0xf00f0f00, 0xf00f0f00, 0xf00f0f00, 0x0ff00000, 0x0ff00000, 0x0ff00000, 0x0ff00000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0xf00ff000, 0xf00ff000, 0xf00ff000, 0xf00ff000,
+        0x0ff00f00, 0x0ff00f00, 0x0ff00f00, 0x0ff00f00, 0xf00ff000, 0xf00ff000, 0xf00ff000, 0xf00ff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0f0f0f00, 0x0f0f0f00, 0x0f0f0f00, 0x0f0f0f00, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000,
+        0x0fffff00, 0x0fffff00, 0x0fffff00, 0x0fffff00, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000,
+        0x0f0f0f00, 0x0f0f0f00, 0x0f0f0f00, 0x0f0f0f00, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x0fffff00, 0x0fffff00, 0x0fffff00, 0x0fffff00,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f00f0, 0x000f00f0, 0x000f00f0, 0x000f00f0,
+        0x00fffff0, 0x00fffff0, 0x00fffff0, 0x00fffff0, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x00fffff0, 0x00fffff0, 0x00fffff0, 0x00fffff0, 0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x00fffff0, 0x00fffff0, 0x00fffff0, 0x00fffff0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0fffff00, 0x0fffff00, 0x0fffff00, 0x0fffff00,
+        0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0ff00000, 0x0ff00000, 0x0ff00000, 0x0ff00000,
+        0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x00000ff0, 0x00000ff0, 0x00000ff0, 0x00000ff0,
+        0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x0ff00000, 0x0ff00000, 0x0ff00000, 0x0ff00000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000ff0, 0x00000ff0, 0x00000ff0, 0x00000ff0,
+        0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x0ff00000, 0x0ff00000, 0x0ff00000, 0x0ff00000,
+        0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x00000ff0, 0x00000ff0, 0x00000ff0, 0x00000ff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00fff00f, 0x00fff00f, 0x00fff00f, 0x00fff00f,
+        0x00f0f00f, 0x00f0f00f, 0x00f0f00f, 0x00f0f00f, 0x00fff0f0, 0x00fff0f0, 0x00fff0f0, 0x00fff0f0,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000
+    },
+    {
+        0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x0000000f, 0x0000000f, 0x0000000f, 0x0000000f, 0x0000000f, 0x0000000f, 0x0000000f, 0x0000000f,
+        0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00fffff0, 0x00fffff0, 0x00fffff0, 0x00fffff0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x00fffff0, 0x00fffff0, 0x00fffff0, 0x00fffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00fffff0, 0x00fffff0, 0x00fffff0, 0x00fffff0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x0000000f, 0x0000000f, 0x0000000f, 0x0000000f, 0x00fff00f, 0x00fff00f, 0x00fff00f, 0x00fff00f,
+        0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0fffff00, 0x0fffff00, 0x0fffff00, 0x0fffff00, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x0fffff00, 0x0fffff00, 0x0fffff00, 0x0fffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000,
+        0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000,
+        0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x000f00f0, 0x000f00f0, 0x000f00f0, 0x000f00f0,
+        0x0000f0f0, 0x0000f0f0, 0x0000f0f0, 0x0000f0f0, 0x0000fff0, 0x0000fff0, 0x0000fff0, 0x0000fff0,
+        0x000f00f0, 0x000f00f0, 0x000f00f0, 0x000f00f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0xff000ff0, 0xff000ff0, 0xff000ff0, 0xff000ff0,
+        0xf0f0f0f0, 0xf0f0f0f0, 0xf0f0f0f0, 0xf0f0f0f0, 0xf00f00f0, 0xf00f00f0, 0xf00f00f0, 0xf00f00f0,
+        0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f000ff0, 0x0f000ff0, 0x0f000ff0, 0x0f000ff0,
+        0x0f00f0f0, 0x0f00f0f0, 0x0f00f0f0, 0x0f00f0f0, 0x0f0f00f0, 0x0f0f00f0, 0x0f0f00f0, 0x0f0f00f0,
+        0x0ff000f0, 0x0ff000f0, 0x0ff000f0, 0x0ff000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00,
+        0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00,
+        0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00,
+        0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00,
+        0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000,
+        0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x000ffff0, 0x000ffff0, 0x000ffff0, 0x000ffff0, 0x0000f0f0, 0x0000f0f0, 0x0000f0f0, 0x0000f0f0,
+        0x000f00f0, 0x000f00f0, 0x000f00f0, 0x000f00f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x00ff0000, 0x00ff0000, 0x00ff0000, 0x00ff0000,
+        0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0xfffffff0, 0xfffffff0, 0xfffffff0, 0xfffffff0, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0xf000000f, 0xf000000f, 0xf000000f, 0xf000000f, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00,
+        0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0,
+        0xf00f00f0, 0xf00f00f0, 0xf00f00f0, 0xf00f00f0, 0xf0f0f0f0, 0xf0f0f0f0, 0xf0f0f0f0, 0xf0f0f0f0,
+        0xff000ff0, 0xff000ff0, 0xff000ff0, 0xff000ff0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00,
+        0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0xf00000f0, 0xf00000f0, 0xf00000f0, 0xf00000f0, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00,
+        0x00f0f000, 0x00f0f000, 0x00f0f000, 0x00f0f000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x0fffff00, 0x0fffff00, 0x0fffff00, 0x0fffff00,
+        0x0ff000f0, 0x0ff000f0, 0x0ff000f0, 0x0ff000f0, 0x0f0fff00, 0x0f0fff00, 0x0f0fff00, 0x0f0fff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0,
+        0x00fffff0, 0x00fffff0, 0x00fffff0, 0x00fffff0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0f000ff0, 0x0f000ff0, 0x0f000ff0, 0x0f000ff0, 0x00fff0f0, 0x00fff0f0, 0x00fff0f0, 0x00fff0f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000,
+        0x0fffff00, 0x0fffff00, 0x0fffff00, 0x0fffff00, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0ff000f0, 0x0ff000f0, 0x0ff000f0, 0x0ff000f0, 0x0f0fff00, 0x0f0fff00, 0x0f0fff00, 0x0f0fff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00f0ff00, 0x00f0ff00, 0x00f0ff00, 0x00f0ff00, 0x00ff00f0, 0x00ff00f0, 0x00ff00f0, 0x00ff00f0,
+        0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f000f0, 0x00f0ff00, 0x00f0ff00, 0x00f0ff00, 0x00f0ff00,
+        0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00
+    },
+    {
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00,
+        0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00,
+        0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x0000fff0, 0x0000fff0, 0x0000fff0, 0x0000fff0
+    },
+    {
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00,
+        0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x000f0f00, 0x000f0f00, 0x000f0f00, 0x000f0f00,
+        0x0000ff00, 0x0000ff00, 0x0000ff00, 0x0000ff00, 0x00ff0f00, 0x00ff0f00, 0x00ff0f00, 0x00ff0f00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x0ff00ff0, 0x0ff00ff0, 0x0ff00ff0, 0x0ff00ff0, 0x0f0ff0f0, 0x0f0ff0f0, 0x0f0ff0f0, 0x0f0ff0f0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x0fff0f00, 0x0fff0f00, 0x0fff0f00, 0x0fff0f00, 0x0f00ff00, 0x0f00ff00, 0x0f00ff00, 0x0f00ff00,
+        0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00fff0f0, 0x00fff0f0, 0x00fff0f0, 0x00fff0f0, 0x0f000ff0, 0x0f000ff0, 0x0f000ff0, 0x0f000ff0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x00fffff0, 0x00fffff0, 0x00fffff0, 0x00fffff0,
+        0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0, 0x000000f0
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x0f0fff00, 0x0f0fff00, 0x0f0fff00, 0x0f0fff00, 0x0ff000f0, 0x0ff000f0, 0x0ff000f0, 0x0ff000f0,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0fffff00, 0x0fffff00, 0x0fffff00, 0x0fffff00,
+        0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000, 0x0f000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00ff0f00, 0x00ff0f00, 0x00ff0f00, 0x00ff0f00, 0x0f00ff00, 0x0f00ff00, 0x0f00ff00, 0x0f00ff00,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000,
+        0x00000f00, 0x00000f00, 0x00000f00, 0x00000f00, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x00f00000, 0x00f00000, 0x00f00000, 0x00f00000, 0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00,
+        0x0ff00f00, 0x0ff00f00, 0x0ff00f00, 0x0ff00f00, 0x0f0ff000, 0x0f0ff000, 0x0f0ff000, 0x0f0ff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0,
+        0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0xf000000f, 0xf000000f, 0xf000000f, 0xf000000f, 0xf000000f, 0xf000000f, 0xf000000f, 0xf000000f,
+        0x0f0ff0f0, 0x0f0ff0f0, 0x0f0ff0f0, 0x0f0ff0f0, 0x0ff00ff0, 0x0ff00ff0, 0x0ff00ff0, 0x0ff00ff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x00f00f00, 0x00f00f00, 0x00f00f00, 0x00f00f00,
+        0x000ff000, 0x000ff000, 0x000ff000, 0x000ff000, 0x0ff00ff0, 0x0ff00ff0, 0x0ff00ff0, 0x0ff00ff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f0000f0, 0x0f000f00, 0x0f000f00, 0x0f000f00, 0x0f000f00,
+        0x00f0f000, 0x00f0f000, 0x00f0f000, 0x00f0f000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x00000ff0, 0x00000ff0, 0x00000ff0, 0x00000ff0
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x00ffff00, 0x00ffff00, 0x00ffff00, 0x00ffff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000, 0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000,
+        0x0000ff00, 0x0000ff00, 0x0000ff00, 0x0000ff00, 0x0000ff00, 0x0000ff00, 0x0000ff00, 0x0000ff00,
+        0x0000f000, 0x0000f000, 0x0000f000, 0x0000f000, 0x00fff000, 0x00fff000, 0x00fff000, 0x00fff000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00, 0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000,
+        0x00ff0000, 0x00ff0000, 0x00ff0000, 0x00ff0000, 0x00ff0000, 0x00ff0000, 0x00ff0000, 0x00ff0000,
+        0x000f0000, 0x000f0000, 0x000f0000, 0x000f0000, 0x000fff00, 0x000fff00, 0x000fff00, 0x000fff00,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x0f00ff00, 0x0f00ff00, 0x0f00ff00, 0x0f00ff00,
+        0x00ff00f0, 0x00ff00f0, 0x00ff00f0, 0x00ff00f0, 0x00000000, 0x00000000, 0x00000000, 0x00000000,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    },
+    {
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0, 0x0ffffff0,
+        0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000
+    }
+};
+
+#endif // GLYPH_FONT_H
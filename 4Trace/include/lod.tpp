@@ -0,0 +1,159 @@
+#ifndef LOD_T
+#define LOD_T
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+
+#include "vec.tpp"
+#include "camera.tpp"
+#include "primitives.tpp"
+
+/*******************************************************************************
+SphereLod class
+    level of detail of a sphere list. The spheres are the leaves of a
+    binary tree split at the median of the longest axis, every inner node
+    has a bounding sphere and a proxy standing for its subtree: a sphere
+    at the area weighted centroid with the summed area (capped to the
+    bound) and the area weighted material. cut() walks the tree from the
+    root and stops at the nodes whose bound covers less than the given
+    pixels for the cone of the primary rays through them, those draw as
+    their proxy, so the spheres of a frame stay bounded by what the image
+    can show. Lights are never merged, they stay apart for the shading
+*******************************************************************************/
+
+template<size_t dim>
+class SphereLod{
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Node{
+        Vector<double, dim> center; // of the bounding sphere
+        double bound;
+        uint32_t left, right;       // children, NONE for a leaf
+        uint32_t sphere;            // index of the leaf sphere
+        bool light;                 // a light in the subtree, never merged
+        Sphere<dim> proxy;
+    };
+
+    std::vector<Sphere<dim>> spheres;
+    std::vector<Node> nodes;
+    std::vector<uint32_t> stack;
+
+    uint32_t build(std::vector<uint32_t>& order, size_t first, size_t last){
+        if(last - first == 1){
+            const Sphere<dim>& s = spheres[order[first]];
+            nodes.push_back(Node{s.center, s.radius, NONE, NONE, order[first], !(s.emission == Color(0)), s});
+            return nodes.size() - 1;
+        }
+
+        Vector<double, dim> lo = spheres[order[first]].center, hi = lo;
+        for(size_t i = first; i < last; i++){
+            for(size_t k = 0; k < dim; k++){
+                lo[k] = std::min(lo[k], spheres[order[i]].center[k]);
+                hi[k] = std::max(hi[k], spheres[order[i]].center[k]);
+            }
+        }
+        size_t axis = 0;
+        for(size_t k = 1; k < dim; k++){
+            if(hi[k] - lo[k] > hi[axis] - lo[axis]){
+                axis = k;
+            }
+        }
+        size_t mid = (first + last) / 2;
+        std::nth_element(order.begin() + first, order.begin() + mid, order.begin() + last,
+                         [&](uint32_t a, uint32_t b){return spheres[a].center[axis] < spheres[b].center[axis];});
+
+        uint32_t left = build(order, first, mid);
+        uint32_t right = build(order, mid, last);
+        const Node& l = nodes[left];
+        const Node& r = nodes[right];
+
+        // smallest sphere around the two children bounds
+        Vector<double, dim> d = r.center - l.center;
+        double dist = d.length();
+        Vector<double, dim> center = l.center;
+        double bound = l.bound;
+        if(dist + l.bound <= r.bound){
+            center = r.center;
+            bound = r.bound;
+        }
+        else if(dist + r.bound > l.bound){
+            bound = (dist + l.bound + r.bound) / 2;
+            center = l.center + d * ((bound - l.bound) / dist);
+        }
+
+        // the proxy keeps the projected area and averages by it
+        double al = l.proxy.radius2, ar = r.proxy.radius2;
+        double area = al + ar;
+        double wl = area > 0 ? al / area : 0.5;
+        double wr = 1 - wl;
+        Sphere<dim> proxy(l.proxy.center * wl + r.proxy.center * wr,
+                          std::min(bound, sqrt(area)),
+                          l.proxy.surface * wl + r.proxy.surface * wr,
+                          Color(0),
+                          l.proxy.transparency * wl + r.proxy.transparency * wr,
+                          l.proxy.reflection * wl + r.proxy.reflection * wr);
+
+        nodes.push_back(Node{center, bound, left, right, NONE, l.light || r.light, proxy});
+        return nodes.size() - 1;
+    }
+
+public:
+    // the root is the last node
+    void build(const std::vector<Sphere<dim>>& list){
+        spheres = list;
+        nodes.clear();
+        if(spheres.empty()){
+            return;
+        }
+        nodes.reserve(2 * spheres.size());
+        std::vector<uint32_t> order(spheres.size());
+        std::iota(order.begin(), order.end(), 0);
+        build(order, 0, order.size());
+    }
+
+    // the spheres the tree was built from
+    const std::vector<Sphere<dim>>& source() const {return spheres;}
+
+    size_t size() const {return nodes.size();}
+
+    // appends to out the spheres seen by the camera: the nodes covering
+    // less than pixels pixels are drawn as their proxy. The primary rays
+    // share their apex and pixel cone, so the footprint of a node only
+    // depends on its distance in the hyperplane of the rays
+    void cut(const Camera<dim>& cam, double pixels, std::vector<Sphere<dim>>& out){
+        if(nodes.empty()){
+            return;
+        }
+        // width of the pixel cone at distance 1
+        double pixel = 2 * cam.tan_half_fov() / cam.height;
+
+        stack.clear();
+        stack.push_back(nodes.size() - 1);
+        while(!stack.empty()){
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+
+            if(node.left == NONE){
+                out.push_back(spheres[node.sphere]);
+                continue;
+            }
+
+            if(!node.light){
+                Vector<double, dim> local = cam.to_camera(node.center);
+                double distance = sqrt(local[0] * local[0] + local[1] * local[1] + local[2] * local[2]) - node.bound;
+                if(distance > 0 && 2 * node.bound < pixels * pixel * distance){
+                    out.push_back(node.proxy);
+                    continue;
+                }
+            }
+            stack.push_back(node.right);
+            stack.push_back(node.left);
+        }
+    }
+};
+
+#endif // LOD_T
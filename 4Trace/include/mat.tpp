@@ -46,14 +46,7 @@ public:
     // ----------------------------- c'tors -----------------------------------
     Matrix() : MROW(0), NCOL(0){}
 
-    Matrix(size_t m, size_t n) : MROW(m), NCOL(n) {
-        // initialize the matrix
-        for(size_t i = 0; i < MROW; i++){
-            for(size_t j = 0; j < NCOL; j++){
-                mat.push_back(T(0));
-            }
-        }
-    }
+    Matrix(size_t m, size_t n) : mat(m * n, T(0)), MROW(m), NCOL(n) {}
 
     Matrix(std::initializer_list<std::initializer_list<T>> lst) :
         MROW(lst.size()),
@@ -90,6 +83,10 @@ public:
         return mat[calc_index(i, j)];
     }
 
+    // the elements, row after row
+    T* data() {return mat.data();}
+    const T* data() const {return mat.data();}
+
     // ------------------------------ operators --------------------------------
 
     friend Matrix operator*(Matrix const& A, Matrix const& B){
@@ -0,0 +1,270 @@
+#ifndef PRIMITIVES_T
+#define PRIMITIVES_T
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+
+#include "vec.tpp"
+
+using Color = V3d;
+
+/*******************************************************************************
+Material
+    shading parameters shared by all the primitives
+*******************************************************************************/
+
+struct Material{
+    Color surface, emission;
+    double transparency, reflection;
+
+    Material(const Color& surface,
+             const Color& emission,
+             double transparency,
+             double reflection ):
+                 surface(surface),
+                 emission(emission),
+                 transparency(transparency),
+                 reflection(reflection)
+                 {}
+
+    bool operator==(const Material& other) const {
+        return surface == other.surface && emission == other.emission &&
+               transparency == other.transparency && reflection == other.reflection;
+    }
+};
+
+/*******************************************************************************
+Sphere class
+*******************************************************************************/
+
+template<size_t dim>
+struct Sphere : Material{
+
+    Vector<double, dim> center;
+    double radius, radius2; // radius and radius squared
+
+    Sphere(const Vector<double, dim>& center,
+          double radius,
+          const Color& surface,
+          const Color& emission,
+          double transparency,
+          double reflection ):
+              Material(surface, emission, transparency, reflection),
+              center(center),
+              radius(radius),
+              radius2(radius * radius)
+              {}
+
+
+    bool intersect(const Vector<double, dim>& rayorig, const Vector<double, dim>& raydir, double& t0, double& t1) const{
+        Vector<double, dim> l = center - rayorig;
+        double tca = l.dot(raydir);
+        if(tca < 0) {return false;}
+        else{
+
+            double d2 = l.dot(l) - tca * tca;
+            if(d2 > radius2) {return false;}
+            else{
+                double thc = sqrt(radius2 - d2);
+                t0 = tca - thc;
+                t1 = tca + thc;
+                return true;
+            }
+        }
+    }
+
+    Vector<double, dim> normal(const Vector<double, dim>& phit) const{
+        Vector<double, dim> n = phit - center;
+        n.normalize();
+        return n;
+    }
+
+    bool operator==(const Sphere& other) const {
+        return Material::operator==(other) && center == other.center && radius == other.radius;
+    }
+};
+
+/*******************************************************************************
+Plane class
+    the hyperplane normal . x = offset, in 3D an infinite plane.
+    Replaces the huge spheres used as floors
+*******************************************************************************/
+
+template<size_t dim>
+struct Plane : Material{
+
+    Vector<double, dim> n; // unit normal
+    double offset;
+
+    // plane through point, normal doesn't need to be normalized
+    Plane(const Vector<double, dim>& point,
+          const Vector<double, dim>& normal,
+          const Color& surface,
+          const Color& emission,
+          double transparency,
+          double reflection ):
+              Material(surface, emission, transparency, reflection),
+              n(normal)
+    {
+        n.normalize();
+        offset = n.dot(point);
+    }
+
+    bool intersect(const Vector<double, dim>& rayorig, const Vector<double, dim>& raydir, double& t) const{
+        double denom = n.dot(raydir);
+        if(std::fabs(denom) < 1e-12) {return false;}
+
+        t = (offset - n.dot(rayorig)) / denom;
+        return t > 0;
+    }
+
+    Vector<double, dim> normal(const Vector<double, dim>&) const{
+        return n;
+    }
+
+    bool operator==(const Plane& other) const {
+        return Material::operator==(other) && n == other.n && offset == other.offset;
+    }
+};
+
+/*******************************************************************************
+Box class
+    axis aligned N-D box [lo, hi]
+*******************************************************************************/
+
+template<size_t dim>
+struct Box : Material{
+
+    Vector<double, dim> lo, hi;
+
+    Box(const Vector<double, dim>& lo,
+        const Vector<double, dim>& hi,
+        const Color& surface,
+        const Color& emission,
+        double transparency,
+        double reflection ):
+            Material(surface, emission, transparency, reflection),
+            lo(lo),
+            hi(hi)
+            {}
+
+    // slab test, same convention as Sphere::intersect: t0 < 0 if the ray
+    // starts inside
+    bool intersect(const Vector<double, dim>& rayorig, const Vector<double, dim>& raydir, double& t0, double& t1) const{
+        double tmin = -INFINITY, tmax = INFINITY;
+        for(size_t k = 0; k < dim; k++){
+            if(raydir[k] == 0){
+                if(rayorig[k] < lo[k] || rayorig[k] > hi[k]) {return false;}
+                continue;
+            }
+            double inv = 1 / raydir[k];
+            double ta = (lo[k] - rayorig[k]) * inv;
+            double tb = (hi[k] - rayorig[k]) * inv;
+            if(ta > tb) {std::swap(ta, tb);}
+            tmin = std::max(tmin, ta);
+            tmax = std::min(tmax, tb);
+            if(tmin > tmax) {return false;}
+        }
+        if(tmax < 0) {return false;}
+
+        t0 = tmin;
+        t1 = tmax;
+        return true;
+    }
+
+    // outward normal of the face closest to phit
+    Vector<double, dim> normal(const Vector<double, dim>& phit) const{
+        size_t axis = 0;
+        double sign = -1;
+        double best = INFINITY;
+        for(size_t k = 0; k < dim; k++){
+            double dlo = std::fabs(phit[k] - lo[k]);
+            double dhi = std::fabs(phit[k] - hi[k]);
+            if(dlo < best) {best = dlo; axis = k; sign = -1;}
+            if(dhi < best) {best = dhi; axis = k; sign = 1;}
+        }
+        Vector<double, dim> n;
+        n[axis] = sign;
+        return n;
+    }
+
+    Vector<double, dim> center() const {return (lo + hi) * 0.5;}
+    double bounding_radius() const {return (hi - lo).length() * 0.5;}
+
+    bool operator==(const Box& other) const {
+        return Material::operator==(other) && lo == other.lo && hi == other.hi;
+    }
+};
+
+/*******************************************************************************
+Scene
+    the primitives are kept in one list per type, so the intersection loops
+    are homogeneous. Only spheres act as (point) lights
+*******************************************************************************/
+
+template<size_t dim>
+class SphereCloud;
+
+template<size_t dim>
+struct Scene{
+    std::vector<Sphere<dim>> spheres;
+    std::vector<Plane<dim>> planes;
+    std::vector<Box<dim>> boxes;
+
+    // spheres streamed from disk (cloud.tpp), not owned
+    const SphereCloud<dim>* cloud = nullptr;
+
+    Scene() {}
+    Scene(const std::vector<Sphere<dim>>& spheres) : spheres(spheres) {}
+
+    void clear(){
+        spheres.clear();
+        planes.clear();
+        boxes.clear();
+        cloud = nullptr;
+    }
+};
+
+// closest intersection found by a ray
+enum class Shape {none, sphere, plane, box, cloud};
+
+struct Hit{
+    double t = INFINITY;
+    Shape shape = Shape::none;
+    size_t index = 0;
+
+    explicit operator bool() const {return shape != Shape::none;}
+};
+
+// distinct for every object, 0 for the background. The shape is in the
+// top byte, the index in the 56 bits below it
+inline uint64_t object_id(const Hit& hit){
+    return uint64_t(hit.shape) << 56 | (uint64_t(hit.index) & 0xFFFFFFFFFFFFFF);
+}
+
+inline Shape id_shape(uint64_t id) {return Shape(id >> 56);}
+inline size_t id_index(uint64_t id) {return size_t(id & 0xFFFFFFFFFFFFFF);}
+
+template<size_t dim>
+const Material& hit_material(const Scene<dim>& scene, const Hit& hit){
+    switch(hit.shape){
+        case Shape::plane: return scene.planes[hit.index];
+        case Shape::box:   return scene.boxes[hit.index];
+        case Shape::cloud: return scene.cloud->material(hit.index);
+        default:           return scene.spheres[hit.index];
+    }
+}
+
+template<size_t dim>
+Vector<double, dim> hit_normal(const Scene<dim>& scene, const Hit& hit, const Vector<double, dim>& phit){
+    switch(hit.shape){
+        case Shape::plane: return scene.planes[hit.index].normal(phit);
+        case Shape::box:   return scene.boxes[hit.index].normal(phit);
+        case Shape::cloud: return scene.cloud->sphere(hit.index).normal(phit);
+        default:           return scene.spheres[hit.index].normal(phit);
+    }
+}
+
+#endif // PRIMITIVES_T
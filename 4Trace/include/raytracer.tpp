@@ -0,0 +1,1833 @@
+#ifndef RAYTRACER_T
+#define RAYTRACER_T
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <atomic>
+#include <string>
+#include <functional>
+
+#include "vec.tpp"
+#include "bmp.h"
+#include "camera.tpp"
+#include "primitives.tpp"
+#include "ThreadPool.h"
+#include "Sampler.h"
+#include "Denoiser.h"
+#include "Arena.h"
+#include "FrameCache.h"
+#include "temporal.tpp"
+#include "cloud.tpp"
+#include "lod.tpp"
+
+constexpr double MAX_RAY_DEPTH = 5;
+constexpr double RAY_BIAS = 1e-4;
+
+// part of the FrameCache keys, to be bumped by any change of the pixels
+// the renderer produces for the same input
+constexpr uint64_t RENDER_VERSION = 1;
+
+inline double mix(double a, double b, double mix){
+    return b * mix + a * (1 - mix);
+}
+
+inline Color background(){
+    return Color(0, 0.2, 0.2);
+}
+
+/*******************************************************************************
+intersection
+    the primitive lists are walked type by type. A tile restricts the
+    spheres and boxes to the ones its primary rays can reach, the planes
+    are unbounded and always tested, so is the hierarchy of a cloud
+*******************************************************************************/
+
+// candidates of the primary rays of a tile, indices in the scene lists
+struct Tile{
+    std::vector<size_t> spheres;
+    std::vector<size_t> boxes;
+
+    // cone around the primary rays of the tile, the axis is a unit vector
+    // in camera coordinates (right, up, backwards)
+    V3d cone_axis = V3d(0, 0, -1);
+    double cone_angle = 0;
+
+    void clear(){
+        spheres.clear();
+        boxes.clear();
+    }
+};
+
+template<size_t dim>
+Hit closest_hit(const Vector<double, dim>& rayorig, const Vector<double, dim>& raydir, const Scene<dim>& scene, const Tile* tile = nullptr){
+    Hit hit;
+
+    size_t nspheres = tile ? tile->spheres.size() : scene.spheres.size();
+    for(size_t k = 0; k < nspheres; k++ ){
+        size_t i = tile ? tile->spheres[k] : k;
+        double t0 = INFINITY, t1 = INFINITY;
+        if(scene.spheres[i].intersect(rayorig, raydir, t0, t1)){
+            if(t0 < 0) t0 = t1;
+            if(t0 < hit.t){
+                hit.t = t0; // distance from rayorig
+                hit.shape = Shape::sphere;
+                hit.index = i;
+            }
+        }
+    }
+
+    for(size_t i = 0; i < scene.planes.size(); i++){
+        double t;
+        if(scene.planes[i].intersect(rayorig, raydir, t) && t < hit.t){
+            hit.t = t;
+            hit.shape = Shape::plane;
+            hit.index = i;
+        }
+    }
+
+    size_t nboxes = tile ? tile->boxes.size() : scene.boxes.size();
+    for(size_t k = 0; k < nboxes; k++ ){
+        size_t i = tile ? tile->boxes[k] : k;
+        double t0, t1;
+        if(scene.boxes[i].intersect(rayorig, raydir, t0, t1)){
+            if(t0 < 0) t0 = t1;
+            if(t0 < hit.t){
+                hit.t = t0;
+                hit.shape = Shape::box;
+                hit.index = i;
+            }
+        }
+    }
+
+    if(scene.cloud){
+        scene.cloud->intersect(rayorig, raydir, hit);
+    }
+
+    return hit;
+}
+
+// true if anything but the sphere light is on the ray closer than tmax
+template<size_t dim>
+bool occluded(const Vector<double, dim>& rayorig, const Vector<double, dim>& raydir, const Scene<dim>& scene, size_t light, double tmax){
+    for(size_t j = 0; j < scene.spheres.size(); j++){
+        double t0, t1;
+        if(j != light && scene.spheres[j].intersect(rayorig, raydir, t0, t1) && t0 < tmax){
+            return true;
+        }
+    }
+
+    for(const Plane<dim>& plane : scene.planes){
+        double t;
+        if(plane.intersect(rayorig, raydir, t) && t < tmax){
+            return true;
+        }
+    }
+
+    for(const Box<dim>& box : scene.boxes){
+        double t0, t1;
+        if(box.intersect(rayorig, raydir, t0, t1) && t0 < tmax){
+            return true;
+        }
+    }
+
+    return scene.cloud && scene.cloud->occluded(rayorig, raydir, tmax);
+}
+
+
+/*******************************************************************************
+primary rays
+    the primary rays all start at the camera position, so the parts of the
+    sphere test that only depend on the origin are computed once per frame:
+    with l = center - origin the ray misses if l . d < 0 or
+    (l . d)^2 < |l|^2 - r^2, which leaves one dot product and a compare
+    per sphere. The planes keep n . origin
+*******************************************************************************/
+
+template<size_t dim>
+struct OriginCache{
+    Vector<double, dim> origin;
+
+    std::vector<Vector<double, dim>> sphere_l; // center - origin
+    std::vector<double> sphere_c;              // |l|^2 - r^2
+    std::vector<double> plane_dist;            // offset - n . origin
+
+    void build(const Scene<dim>& scene, const Vector<double, dim>& o){
+        origin = o;
+
+        sphere_l.resize(scene.spheres.size());
+        sphere_c.resize(scene.spheres.size());
+        for(size_t i = 0; i < scene.spheres.size(); i++){
+            sphere_l[i] = scene.spheres[i].center - origin;
+            sphere_c[i] = sphere_l[i].dot(sphere_l[i]) - scene.spheres[i].radius2;
+        }
+
+        plane_dist.resize(scene.planes.size());
+        for(size_t i = 0; i < scene.planes.size(); i++){
+            plane_dist[i] = scene.planes[i].offset - scene.planes[i].n.dot(origin);
+        }
+    }
+};
+
+// closest_hit() for a ray starting at cache.origin
+template<size_t dim>
+Hit primary_hit(const Vector<double, dim>& raydir, const Scene<dim>& scene, const OriginCache<dim>& cache, const Tile* tile = nullptr){
+    Hit hit;
+
+    size_t nspheres = tile ? tile->spheres.size() : scene.spheres.size();
+    for(size_t k = 0; k < nspheres; k++ ){
+        size_t i = tile ? tile->spheres[k] : k;
+        double tca = cache.sphere_l[i].dot(raydir);
+        double tca2 = tca * tca;
+        if(tca < 0 || tca2 < cache.sphere_c[i]) {continue;}
+
+        double thc = sqrt(tca2 - cache.sphere_c[i]);
+        double t0 = tca - thc;
+        if(t0 < 0) t0 = tca + thc;
+        if(t0 < hit.t){
+            hit.t = t0;
+            hit.shape = Shape::sphere;
+            hit.index = i;
+        }
+    }
+
+    for(size_t i = 0; i < scene.planes.size(); i++){
+        double denom = scene.planes[i].n.dot(raydir);
+        if(std::fabs(denom) < 1e-12) {continue;}
+
+        double t = cache.plane_dist[i] / denom;
+        if(t > 0 && t < hit.t){
+            hit.t = t;
+            hit.shape = Shape::plane;
+            hit.index = i;
+        }
+    }
+
+    size_t nboxes = tile ? tile->boxes.size() : scene.boxes.size();
+    for(size_t k = 0; k < nboxes; k++ ){
+        size_t i = tile ? tile->boxes[k] : k;
+        double t0, t1;
+        if(scene.boxes[i].intersect(cache.origin, raydir, t0, t1)){
+            if(t0 < 0) t0 = t1;
+            if(t0 < hit.t){
+                hit.t = t0;
+                hit.shape = Shape::box;
+                hit.index = i;
+            }
+        }
+    }
+
+    if(scene.cloud){
+        scene.cloud->intersect(cache.origin, raydir, hit);
+    }
+
+    return hit;
+}
+
+
+/*******************************************************************************
+lights
+    the emissive spheres are point lights at their center. Lights is built
+    once per frame and lists them with their importance (mean emission),
+    so a diffuse hit doesn't walk every sphere. Lights below the horizon of
+    the surface add nothing and are culled before their shadow ray. With
+    samples > 0 only that many shadow rays are cast per hit: the lights are
+    picked in proportion to emission * cosine (stratified, one random
+    number per hit) and weighted by the inverse of their probability, so
+    the cost per hit no longer grows with the number of lights. The light
+    model has no distance falloff, so the estimate doesn't depend on the
+    distance either
+*******************************************************************************/
+
+template<size_t dim>
+struct Lights{
+    // indices in scene.spheres and importance of the emissive spheres
+    std::vector<size_t> index;
+    std::vector<double> power;
+
+    // shadow rays per diffuse hit, 0 evaluates every light
+    size_t samples = 0;
+
+    // soft shadows, 0 keeps the point lights. A light is first probed with
+    // area_samples shadow rays, if they disagree the point is in the
+    // penumbra and up to area_max_samples are cast
+    size_t area_samples = 0;
+    size_t area_max_samples = 0;
+
+    size_t size() const {return index.size();}
+
+    void build(const Scene<dim>& scene){
+        index.clear();
+        power.clear();
+        for(size_t i = 0; i < scene.spheres.size(); i++){
+            const Color& e = scene.spheres[i].emission;
+            if(!(e == Color(0))){
+                index.push_back(i);
+                power.push_back((e[0] + e[1] + e[2]) / 3);
+            }
+        }
+    }
+};
+
+/*******************************************************************************
+area lights
+    for soft shadows the emissive sphere is seen as the disk through its
+    center facing the shaded point, and the shadow rays aim at R2 points
+    on it (rotated per pixel and per light by the sampler). The disk is
+    2D in every dimension: it is spanned by the two world axes least
+    aligned with the light direction, made orthogonal to it. The shading
+    keeps the direction of the center, only the visibility is averaged
+*******************************************************************************/
+
+// orthonormal e1, e2 orthogonal to the unit vector l
+template<size_t dim>
+void disk_basis(const Vector<double, dim>& l, Vector<double, dim>& e1, Vector<double, dim>& e2){
+    // the two axes with the smallest components of l
+    size_t a = 0, b = 1;
+    if(std::fabs(l[b]) < std::fabs(l[a])) {std::swap(a, b);}
+    for(size_t k = 2; k < dim; k++){
+        if(std::fabs(l[k]) < std::fabs(l[a])) {b = a; a = k;}
+        else if(std::fabs(l[k]) < std::fabs(l[b])) {b = k;}
+    }
+
+    e1 = Vector<double, dim>();
+    e1[a] = 1;
+    e1 -= l * l.dot(e1);
+    e1.normalize();
+
+    e2 = Vector<double, dim>();
+    e2[b] = 1;
+    e2 -= l * l.dot(e2) + e1 * e1.dot(e2);
+    e2.normalize();
+}
+
+// fraction of the light i seen from phit, light_direction is the unit
+// vector to its center. Point lights (or no sampler) give 0 or 1
+template<size_t dim>
+double light_visibility(const Vector<double, dim>& phit, const Vector<double, dim>& nhit, const Vector<double, dim>& light_direction, double light_distance,
+                        const Scene<dim>& scene, size_t i, const Lights<dim>* lights, Sampler* sampler){
+    Vector<double, dim> origin = phit + nhit * RAY_BIAS;
+
+    if(!lights || lights->area_samples == 0 || !sampler){
+        return occluded(origin, light_direction, scene, i, light_distance) ? 0 : 1;
+    }
+
+    const Sphere<dim>& light = scene.spheres[i];
+    Vector<double, dim> e1, e2;
+    disk_basis(light_direction, e1, e2);
+
+    double du = sampler->next();
+    double dv = sampler->next();
+
+    size_t probes = lights->area_samples;
+    size_t max_samples = std::max(probes, lights->area_max_samples);
+
+    size_t visible = 0;
+    size_t n = 0;
+    for(; n < max_samples; n++){
+        // all the probes agree: fully lit or in the umbra
+        if(n == probes && (visible == 0 || visible == n)){
+            break;
+        }
+
+        double u, v, x, y;
+        Sampler::r2(n, du, dv, u, v);
+        Sampler::disk(u, v, x, y);
+
+        Vector<double, dim> target = light.center + (e1 * x + e2 * y) * light.radius;
+        Vector<double, dim> direction = target - origin;
+        double distance = direction.length();
+        direction.normalize();
+
+        if(!occluded(origin, direction, scene, i, distance)){
+            visible++;
+        }
+    }
+    return visible / double(n);
+}
+
+// light of the sphere i reaching the diffuse surface at phit, nhit faces
+// the incoming ray. Lights behind the surface cast no shadow ray
+template<size_t dim>
+Color light_contribution(const Vector<double, dim>& phit, const Vector<double, dim>& nhit, const Material& material, const Scene<dim>& scene, size_t i,
+                         const Lights<dim>* lights = nullptr, Sampler* sampler = nullptr){
+    const Sphere<dim>& light = scene.spheres[i];
+
+    Vector<double, dim> light_direction = light.center - phit;
+    double light_distance = light_direction.length();
+    light_direction.normalize();
+
+    double cosine = nhit.dot(light_direction);
+    if(cosine <= 0){
+        return Color(0);
+    }
+
+    // 0 if there is an object obstructing the light ray
+    double visibility = light_visibility(phit, nhit, light_direction, light_distance, scene, i, lights, sampler);
+    if(visibility == 0){
+        return Color(0);
+    }
+
+    // calculate how the light changes the color
+    Color color = material.surface * cosine * light.emission;
+    if(visibility < 1){
+        color *= visibility;
+    }
+    return color;
+}
+
+// importance of light k of lights for the surface at phit
+template<size_t dim>
+double light_estimate(const Vector<double, dim>& phit, const Vector<double, dim>& nhit, const Scene<dim>& scene, const Lights<dim>& lights, size_t k){
+    Vector<double, dim> light_direction = scene.spheres[lights.index[k]].center - phit;
+    double cosine = nhit.dot(light_direction);
+    if(cosine <= 0){
+        return 0;
+    }
+    return lights.power[k] * cosine / light_direction.length();
+}
+
+// light reaching the diffuse surface at phit, without lights every sphere
+// is checked. The sampler is needed when lights.samples > 0
+template<size_t dim>
+Color direct_light(const Vector<double, dim>& phit, const Vector<double, dim>& nhit, const Material& material, const Scene<dim>& scene, const Lights<dim>* lights = nullptr, Sampler* sampler = nullptr){
+    Color surfaceColor(0);
+
+    if(material.surface == Color(0)){
+        return surfaceColor;
+    }
+
+    if(!lights){
+        for(size_t i = 0; i < scene.spheres.size(); i++){
+            if(!(scene.spheres[i].emission == Color(0))){
+                surfaceColor += light_contribution(phit, nhit, material, scene, i);
+            }
+        }
+        return surfaceColor;
+    }
+
+    size_t nlights = lights->size();
+    if(lights->samples == 0 || lights->samples >= nlights || !sampler){
+        for(size_t k = 0; k < nlights; k++){
+            surfaceColor += light_contribution(phit, nhit, material, scene, lights->index[k], lights, sampler);
+        }
+        return surfaceColor;
+    }
+
+    double total = 0;
+    for(size_t k = 0; k < nlights; k++){
+        total += light_estimate(phit, nhit, scene, *lights, k);
+    }
+    if(total <= 0){
+        return surfaceColor;
+    }
+
+    // systematic sampling of the cumulative estimate: the n-th pick is
+    // at (n + u) * total / samples, a light is picked as many times as
+    // these points fall in its interval
+    size_t samples = lights->samples;
+    double step = total / samples;
+    double next = sampler->next() * step;
+    double cumulative = 0;
+    size_t picked = 0;
+
+    for(size_t k = 0; k < nlights && picked < samples; k++){
+        double estimate = light_estimate(phit, nhit, scene, *lights, k);
+        if(estimate <= 0) {continue;}
+        cumulative += estimate;
+
+        size_t count = 0;
+        while(next < cumulative && picked < samples){
+            next += step;
+            count++;
+            picked++;
+        }
+        if(count > 0){
+            // probability estimate / total per pick
+            surfaceColor += light_contribution(phit, nhit, material, scene, lights->index[k], lights, sampler) * (count * step / estimate);
+        }
+    }
+    return surfaceColor;
+}
+
+
+// first hit of a primary ray, what the aux buffers keep
+template<size_t dim>
+struct PrimaryHit{
+    Hit hit;
+    Vector<double, dim> normal; // facing the ray
+    int depth = 0;              // deepest bounce of the path
+};
+
+
+/*******************************************************************************
+trace function:
+    calculates the color of the ray coming from a pixel
+*******************************************************************************/
+
+// tile restricts the search of the closest hit for the primary rays of a
+// tile, shadows and secondary rays see the whole scene. origin, if given,
+// holds the constants of rayorig for the primary rays. lights and sampler
+// are passed to direct_light() along the whole path. first, if given,
+// receives the hit of this ray and the depth of its path
+template<size_t dim>
+Color trace(const Vector<double, dim>& rayorig, const Vector<double, dim>& raydir, const Scene<dim>& scene, const int& depth, const Tile* tile = nullptr, const OriginCache<dim>* origin = nullptr,
+            const Lights<dim>* lights = nullptr, Sampler* sampler = nullptr, PrimaryHit<dim>* first = nullptr) {
+
+    Hit hit = origin ? primary_hit(raydir, scene, *origin, tile) : closest_hit(rayorig, raydir, scene, tile);
+    if(first){
+        first->hit = hit;
+        first->depth = depth;
+    }
+
+    // if there's nothing return the background color
+    if(!hit) {
+        return background();
+    }
+    else{
+        const Material& material = hit_material(scene, hit);
+
+        Color surfaceColor(0);
+        Vector<double, dim> phit = rayorig + raydir * hit.t;
+        Vector<double, dim> nhit = hit_normal(scene, hit, phit);
+
+        // switch to decide if the object is hit from the inside ths will flip
+        // the normal
+        bool inside = false;
+        if(raydir.dot(nhit) > 0){
+            nhit = -nhit;
+            inside = true;
+        }
+        if(first){
+            first->normal = nhit;
+        }
+
+        if((material.transparency > 0 || material.reflection > 0) && depth < MAX_RAY_DEPTH){
+            double facingratio = -raydir.dot(nhit);
+            double fresneleffect = mix(pow(1 - facingratio, 3), 1, material.reflection);
+
+            Vector<double, dim> refldir = raydir - nhit * 2 * raydir.dot(nhit);
+            refldir.normalize();
+
+            // the deeper rays only report the depth of their paths
+            PrimaryHit<dim> deeper;
+            PrimaryHit<dim>* below = first ? &deeper : nullptr;
+
+            Color reflection = trace<dim>(phit + nhit * RAY_BIAS, refldir, scene, depth + 1, nullptr, nullptr, lights, sampler, below);
+            if(first){
+                first->depth = std::max(first->depth, deeper.depth);
+            }
+
+            Color refraction(0);
+
+            if(material.transparency > 0){
+                double ior = 1.1;
+                double eta = (inside)? ior : 1;
+                double cosi = -nhit.dot(raydir);
+                double k = 1 - eta * eta * (1 - cosi * cosi);
+                Vector<double, dim> refdir = raydir * eta + nhit * (eta * cosi - sqrt(k));
+                refdir.normalize();
+
+                refraction = trace<dim>(phit - nhit * RAY_BIAS, refdir, scene, depth + 1, nullptr, nullptr, lights, sampler, below);
+                if(first){
+                    first->depth = std::max(first->depth, deeper.depth);
+                }
+            }
+
+            surfaceColor = (reflection * fresneleffect +
+                            refraction * (1 - fresneleffect) * material.transparency) *
+                            material.surface;
+
+        }
+        else{
+            // the object has a diffuse color (neither reflective nor transparent)
+            surfaceColor = direct_light(phit, nhit, material, scene, lights, sampler);
+        }
+        return surfaceColor + material.emission;
+    }
+};
+
+/*******************************************************************************
+wavefront engine
+    alternative to trace(): the rays of a bounce are stored structure of
+    arrays and intersected in bulk, one primitive against all the rays, then
+    the hits are sorted by material class and every class is shaded in its
+    own loop, which emits the rays of the next bounce. Each ray carries the
+    weight of its contribution to the pixel, so the recursion of trace()
+    becomes a sum over the waves. The ray, hit and pixel records of a batch
+    are taken from the arena of the wavefront, which is reset by begin(),
+    so once it reaches its peak size a batch doesn't allocate
+*******************************************************************************/
+
+template<size_t dim>
+struct RayBuffer{
+    ArenaArray<double> org[dim];
+    ArenaArray<double> dir[dim];
+    ArenaArray<Color> weight;
+    ArenaArray<uint32_t> pixel; // slot the ray contributes to
+    // branch of the path of the slot: 1 for the primary ray, 2p for the
+    // reflection of p and 2p + 1 for its refraction
+    ArenaArray<uint32_t> path;
+
+    size_t size() const {return pixel.size();}
+
+    // room for n rays, the buffer is emptied
+    void reserve(Arena& arena, size_t n){
+        for(size_t k = 0; k < dim; k++){
+            org[k].reserve(arena, n);
+            dir[k].reserve(arena, n);
+        }
+        weight.reserve(arena, n);
+        pixel.reserve(arena, n);
+        path.reserve(arena, n);
+    }
+
+    void push(const Vector<double, dim>& o, const Vector<double, dim>& d, const Color& w, uint32_t px, uint32_t branch = 1){
+        for(size_t k = 0; k < dim; k++){
+            org[k].push_back(o[k]);
+            dir[k].push_back(d[k]);
+        }
+        weight.push_back(w);
+        pixel.push_back(px);
+        path.push_back(branch);
+    }
+
+    Vector<double, dim> origin(size_t r) const {
+        Vector<double, dim> o;
+        for(size_t k = 0; k < dim; k++){
+            o[k] = org[k][r];
+        }
+        return o;
+    }
+
+    Vector<double, dim> direction(size_t r) const {
+        Vector<double, dim> d;
+        for(size_t k = 0; k < dim; k++){
+            d[k] = dir[k][r];
+        }
+        return d;
+    }
+};
+
+// shading queues, in the order they are stored
+enum class MaterialClass : uint8_t {miss, diffuse, emissive, reflective, refractive};
+constexpr size_t MATERIAL_CLASSES = 5;
+
+inline MaterialClass material_class(const Material& material, int depth){
+    if((material.transparency > 0 || material.reflection > 0) && depth < MAX_RAY_DEPTH){
+        return material.transparency > 0 ? MaterialClass::refractive : MaterialClass::reflective;
+    }
+    return (material.emission == Color(0)) ? MaterialClass::diffuse : MaterialClass::emissive;
+}
+
+template<size_t dim>
+class Wavefront{
+private:
+    // everything below lives in it until the next begin()
+    Arena arena;
+
+    RayBuffer<dim> rays, next;
+
+    // closest hit of every ray
+    ArenaArray<double> hit_t;
+    ArenaArray<Shape> hit_shape;
+    ArenaArray<uint32_t> hit_index;
+
+    // ray indices grouped by material class, class c is in
+    // [queue_begin[c], queue_begin[c + 1])
+    ArenaArray<uint32_t> queue;
+    ArenaArray<MaterialClass> ray_class;
+    size_t queue_begin[MATERIAL_CLASSES + 1];
+
+    ArenaArray<Color> pixels;
+    ArenaArray<PrimaryHit<dim>> first_hits;
+
+    // the sampler of a diffuse hit is started from the pixel key
+    uint64_t first_pixel = 0, frame = 0;
+
+    Hit hit(size_t r) const {
+        Hit h;
+        h.t = hit_t[r];
+        h.shape = hit_shape[r];
+        h.index = hit_index[r];
+        return h;
+    }
+
+    // same tests and order as closest_hit(), so the hits are the same. The
+    // primitive is loaded once and the ray loops work on raw pointers, so
+    // the compiler can keep them in registers
+    void intersect(const Scene<dim>& scene, const Tile* tile, const OriginCache<dim>* origin){
+        size_t n = rays.size();
+        hit_t.assign(arena, n, INFINITY);
+        hit_shape.assign(arena, n, Shape::none);
+        hit_index.assign(arena, n, 0);
+
+        const double* org[dim];
+        const double* dir[dim];
+        for(size_t c = 0; c < dim; c++){
+            org[c] = rays.org[c].data();
+            dir[c] = rays.dir[c].data();
+        }
+        double* ht = hit_t.data();
+        Shape* hs = hit_shape.data();
+        uint32_t* hi = hit_index.data();
+
+        size_t nspheres = tile ? tile->spheres.size() : scene.spheres.size();
+        for(size_t k = 0; k < nspheres; k++){
+            uint32_t i = tile ? tile->spheres[k] : k;
+
+            if(origin){
+                // primary rays, see primary_hit()
+                double l[dim];
+                for(size_t c = 0; c < dim; c++){
+                    l[c] = origin->sphere_l[i][c];
+                }
+                double sphere_c = origin->sphere_c[i];
+
+                for(size_t r = 0; r < n; r++){
+                    double tca = 0;
+                    for(size_t c = 0; c < dim; c++){
+                        tca += l[c] * dir[c][r];
+                    }
+                    double tca2 = tca * tca;
+                    if(tca < 0 || tca2 < sphere_c) {continue;}
+
+                    double thc = std::sqrt(tca2 - sphere_c);
+                    double t0 = tca - thc;
+                    if(t0 < 0) t0 = tca + thc;
+                    if(t0 < ht[r]){
+                        ht[r] = t0;
+                        hs[r] = Shape::sphere;
+                        hi[r] = i;
+                    }
+                }
+                continue;
+            }
+
+            const Sphere<dim>& sphere = scene.spheres[i];
+            double center[dim];
+            for(size_t c = 0; c < dim; c++){
+                center[c] = sphere.center[c];
+            }
+            double radius2 = sphere.radius2;
+
+            for(size_t r = 0; r < n; r++){
+                double tca = 0, l2 = 0;
+                for(size_t c = 0; c < dim; c++){
+                    double l = center[c] - org[c][r];
+                    tca += l * dir[c][r];
+                    l2 += l * l;
+                }
+                double h2 = radius2 - (l2 - tca * tca);
+                if(tca < 0 || h2 < 0) {continue;}
+
+                double thc = std::sqrt(h2);
+                double t0 = tca - thc;
+                if(t0 < 0) t0 = tca + thc;
+                if(t0 < ht[r]){
+                    ht[r] = t0;
+                    hs[r] = Shape::sphere;
+                    hi[r] = i;
+                }
+            }
+        }
+
+        for(size_t i = 0; i < scene.planes.size(); i++){
+            const Plane<dim>& plane = scene.planes[i];
+            double normal[dim];
+            for(size_t c = 0; c < dim; c++){
+                normal[c] = plane.n[c];
+            }
+
+            for(size_t r = 0; r < n; r++){
+                double denom = 0;
+                for(size_t c = 0; c < dim; c++){
+                    denom += normal[c] * dir[c][r];
+                }
+                if(std::fabs(denom) < 1e-12) {continue;}
+
+                double dist = 0;
+                if(origin){
+                    dist = origin->plane_dist[i];
+                }
+                else{
+                    double ndoto = 0;
+                    for(size_t c = 0; c < dim; c++){
+                        ndoto += normal[c] * org[c][r];
+                    }
+                    dist = plane.offset - ndoto;
+                }
+
+                double t = dist / denom;
+                if(t > 0 && t < ht[r]){
+                    ht[r] = t;
+                    hs[r] = Shape::plane;
+                    hi[r] = i;
+                }
+            }
+        }
+
+        // boxes are rare, the slab test works on gathered rays
+        size_t nboxes = tile ? tile->boxes.size() : scene.boxes.size();
+        for(size_t k = 0; k < nboxes; k++){
+            size_t i = tile ? tile->boxes[k] : k;
+            for(size_t r = 0; r < n; r++){
+                double t0, t1;
+                if(scene.boxes[i].intersect(rays.origin(r), rays.direction(r), t0, t1)){
+                    if(t0 < 0) t0 = t1;
+                    if(t0 < hit_t[r]){
+                        hit_t[r] = t0;
+                        hit_shape[r] = Shape::box;
+                        hit_index[r] = i;
+                    }
+                }
+            }
+        }
+
+        // the clouds walk their hierarchy ray by ray
+        if(scene.cloud){
+            for(size_t r = 0; r < n; r++){
+                Hit h = hit(r);
+                if(scene.cloud->intersect(rays.origin(r), rays.direction(r), h)){
+                    hit_t[r] = h.t;
+                    hit_shape[r] = h.shape;
+                    hit_index[r] = h.index;
+                }
+            }
+        }
+    }
+
+    // counting sort of the rays by material class
+    void sort(const Scene<dim>& scene, int depth){
+        size_t n = rays.size();
+        size_t count[MATERIAL_CLASSES] = {0};
+
+        ray_class.resize(arena, n);
+        for(size_t r = 0; r < n; r++){
+            MaterialClass c = MaterialClass::miss;
+            if(hit_shape[r] != Shape::none){
+                c = material_class(hit_material(scene, hit(r)), depth);
+            }
+            ray_class[r] = c;
+            count[size_t(c)]++;
+        }
+
+        queue_begin[0] = 0;
+        for(size_t c = 0; c < MATERIAL_CLASSES; c++){
+            queue_begin[c + 1] = queue_begin[c] + count[c];
+        }
+
+        size_t fill[MATERIAL_CLASSES];
+        std::copy(queue_begin, queue_begin + MATERIAL_CLASSES, fill);
+
+        queue.resize(arena, n);
+        for(size_t r = 0; r < n; r++){
+            queue[fill[size_t(ray_class[r])]++] = r;
+        }
+    }
+
+    void shade_miss(){
+        Color bg = background();
+        for(size_t q = queue_begin[size_t(MaterialClass::miss)]; q < queue_begin[size_t(MaterialClass::miss) + 1]; q++){
+            size_t r = queue[q];
+            pixels[rays.pixel[r]] += rays.weight[r] * bg;
+        }
+    }
+
+    // diffuse and emissive surfaces end the path
+    void shade_diffuse(const Scene<dim>& scene, MaterialClass c, const Lights<dim>* lights, Sampler* sampler){
+        for(size_t q = queue_begin[size_t(c)]; q < queue_begin[size_t(c) + 1]; q++){
+            size_t r = queue[q];
+            const Material& material = hit_material(scene, hit(r));
+
+            Vector<double, dim> raydir = rays.direction(r);
+            Vector<double, dim> phit = rays.origin(r) + raydir * hit_t[r];
+            Vector<double, dim> nhit = hit_normal(scene, hit(r), phit);
+            if(raydir.dot(nhit) > 0){
+                nhit = -nhit;
+            }
+
+            if(sampler){
+                // each branch of the path ends once, so the reflected and
+                // refracted rays of a hit get their own streams. The codes
+                // of MAX_RAY_DEPTH bounces are below 64
+                sampler->start((first_pixel + rays.pixel[r]) << 6 | rays.path[r], frame);
+            }
+
+            pixels[rays.pixel[r]] += rays.weight[r] * (direct_light(phit, nhit, material, scene, lights, sampler) + material.emission);
+        }
+    }
+
+    // reflective and refractive surfaces pass their weight to the rays of
+    // the next bounce, rays with no weight left are dropped
+    void shade_specular(const Scene<dim>& scene, MaterialClass c){
+        for(size_t q = queue_begin[size_t(c)]; q < queue_begin[size_t(c) + 1]; q++){
+            size_t r = queue[q];
+            const Material& material = hit_material(scene, hit(r));
+            const Color& weight = rays.weight[r];
+            uint32_t px = rays.pixel[r];
+            uint32_t branch = rays.path[r];
+
+            Vector<double, dim> raydir = rays.direction(r);
+            Vector<double, dim> phit = rays.origin(r) + raydir * hit_t[r];
+            Vector<double, dim> nhit = hit_normal(scene, hit(r), phit);
+
+            bool inside = false;
+            if(raydir.dot(nhit) > 0){
+                nhit = -nhit;
+                inside = true;
+            }
+
+            double facingratio = -raydir.dot(nhit);
+            double fresneleffect = mix(pow(1 - facingratio, 3), 1, material.reflection);
+
+            Color reflection_weight = weight * material.surface * fresneleffect;
+            if(!(reflection_weight == Color(0))){
+                Vector<double, dim> refldir = raydir - nhit * 2 * raydir.dot(nhit);
+                refldir.normalize();
+                next.push(phit + nhit * RAY_BIAS, refldir, reflection_weight, px, 2 * branch);
+            }
+
+            if(c == MaterialClass::refractive){
+                Color refraction_weight = weight * material.surface * ((1 - fresneleffect) * material.transparency);
+                if(!(refraction_weight == Color(0))){
+                    double ior = 1.1;
+                    double eta = (inside)? ior : 1;
+                    double cosi = -nhit.dot(raydir);
+                    double k = 1 - eta * eta * (1 - cosi * cosi);
+                    Vector<double, dim> refdir = raydir * eta + nhit * (eta * cosi - sqrt(k));
+                    refdir.normalize();
+                    next.push(phit - nhit * RAY_BIAS, refdir, refraction_weight, px, 2 * branch + 1);
+                }
+            }
+
+            pixels[px] += weight * material.emission;
+        }
+    }
+
+    // records the hits of the primary rays of the slots, see first_hit()
+    void record_first_hits(const Scene<dim>& scene){
+        first_hits.assign(arena, pixels.size(), PrimaryHit<dim>());
+        for(size_t r = 0; r < rays.size(); r++){
+            PrimaryHit<dim>& first = first_hits[rays.pixel[r]];
+            first.hit = hit(r);
+            if(first.hit){
+                Vector<double, dim> raydir = rays.direction(r);
+                Vector<double, dim> phit = rays.origin(r) + raydir * hit_t[r];
+                first.normal = hit_normal(scene, first.hit, phit);
+                if(raydir.dot(first.normal) > 0){
+                    first.normal = -first.normal;
+                }
+            }
+        }
+    }
+
+public:
+    // starts a new batch of npixels slots, up to npixels primary rays are
+    // pushed in the returned buffer with weight 1. Slot k is the pixel
+    // first + k for the samplers
+    RayBuffer<dim>& begin(size_t npixels, uint64_t first = 0, uint64_t frame_number = 0){
+        first_pixel = first;
+        frame = frame_number;
+        arena.reset();
+        pixels.assign(arena, npixels, Color(0));
+        rays.reserve(arena, npixels);
+        return rays;
+    }
+
+    // traces the waves until no ray is left, tile and origin restrict the
+    // primary rays like in trace(), with origin they all start there.
+    // lights and sampler are used like in trace(). With record the primary
+    // hits and the depth of the paths are kept for first_hit()
+    void trace(const Scene<dim>& scene, const Tile* tile = nullptr, const OriginCache<dim>* origin = nullptr,
+               const Lights<dim>* lights = nullptr, Sampler* sampler = nullptr, bool record = false){
+        for(int depth = 0; rays.size() > 0; depth++){
+            if(depth == 0){
+                intersect(scene, tile, origin);
+                if(record){
+                    record_first_hits(scene);
+                }
+            }
+            else{
+                intersect(scene, nullptr, nullptr);
+                if(record){
+                    for(size_t r = 0; r < rays.size(); r++){
+                        first_hits[rays.pixel[r]].depth = depth;
+                    }
+                }
+            }
+            sort(scene, depth);
+
+            // a reflective ray spawns at most one ray, a refractive two
+            size_t reflective = queue_begin[size_t(MaterialClass::reflective) + 1] - queue_begin[size_t(MaterialClass::reflective)];
+            size_t refractive = queue_begin[size_t(MaterialClass::refractive) + 1] - queue_begin[size_t(MaterialClass::refractive)];
+            next.reserve(arena, reflective + 2 * refractive);
+
+            shade_miss();
+            shade_diffuse(scene, MaterialClass::diffuse, lights, sampler);
+            shade_diffuse(scene, MaterialClass::emissive, lights, sampler);
+            shade_specular(scene, MaterialClass::reflective);
+            shade_specular(scene, MaterialClass::refractive);
+
+            std::swap(rays, next);
+        }
+    }
+
+    const Color& color(size_t px) const {return pixels[px];}
+    const PrimaryHit<dim>& first_hit(size_t px) const {return first_hits[px];}
+
+    ArenaStats memory() const {return arena.stats();}
+};
+
+
+/*******************************************************************************
+tile culling
+    per frame visibility prepass. The image is split in square tiles and
+    every sphere (and the bounding sphere of every box) is projected to a
+    conservative pixel bounding box; each tile keeps the (ordered) indices
+    of the objects overlapping it, so the primary rays of a tile only test
+    those. Objects behind the camera, out of the frustum or not reaching
+    the camera hyperplane are in no list
+*******************************************************************************/
+
+constexpr size_t TILE_SIZE = 16;
+
+struct TileGrid{
+    size_t ntiles_x = 0, ntiles_y = 0;
+
+    // tile rows [ty0, ty1) are built, all of them unless the frame is
+    // rendered in strips
+    size_t ty0 = 0, ty1 = 0;
+
+    // tile (tx, ty) is at tx * rows() + ty - ty0, ty counts from the bottom row
+    std::vector<Tile> tiles;
+
+    size_t rows() const {return ty1 - ty0;}
+
+    Tile& tile(size_t tx, size_t ty) {return tiles[tx * rows() + ty - ty0];}
+
+    size_t tile_x(size_t tile) const {return tile / rows();}
+    size_t tile_y(size_t tile) const {return ty0 + tile % rows();}
+
+    // index of the tile in the whole frame, the same for strips
+    size_t frame_tile(size_t tile) const {return tile_x(tile) * ntiles_y + tile_y(tile);}
+};
+
+
+// range of the slopes u / f seen from the camera for a disk of radius r
+// centered in (u, f), f being the distance along the view direction.
+// Returns false if the disk is completely behind the camera
+inline bool slope_range(double u, double f, double r, double& lo, double& hi){
+    if(f <= -r){
+        return false;
+    }
+
+    double dist2 = u * u + f * f;
+    if(dist2 <= r * r){
+        // the camera is inside, every direction can hit
+        lo = -INFINITY;
+        hi = INFINITY;
+        return true;
+    }
+
+    // the tangents from the camera are at center_angle +- half_angle
+    double center_angle = atan2(u, f);
+    double half_angle = asin(r / sqrt(dist2));
+
+    double a0 = center_angle - half_angle;
+    double a1 = center_angle + half_angle;
+
+    lo = (a0 <= -M_PI / 2) ? -INFINITY : tan(a0);
+    hi = (a1 >=  M_PI / 2) ?  INFINITY : tan(a1);
+    return true;
+}
+
+// pixel range [p0, p1] covered by the slopes [lo, hi], n pixels spanning
+// the slopes [-scale, scale]. Returns false if the range is outside
+inline bool pixel_range(double lo, double hi, double scale, size_t n, size_t& p0, size_t& p1){
+    // pixel p is at slope scale * (2 * (p + 0.5) / n - 1), one pixel margin
+    double fp0 = (lo / scale + 1) * n / 2 - 0.5 - 1;
+    double fp1 = (hi / scale + 1) * n / 2 - 0.5 + 1;
+
+    if(fp1 < 0 || fp0 > double(n - 1)){
+        return false;
+    }
+
+    p0 = (fp0 <= 0) ? 0 : size_t(fp0);
+    p1 = (fp1 >= double(n - 1)) ? n - 1 : size_t(ceil(fp1));
+    return true;
+}
+
+// tile range [tx0, tx1] x [ty0, ty1] a ball can be seen in, returns false
+// if it can't be seen at all
+template<size_t dim>
+bool tile_range(const Vector<double, dim>& center, double radius2, const Camera<dim>& camera, size_t& tx0, size_t& tx1, size_t& ty0, size_t& ty1){
+    unsigned width = camera.width, height = camera.height;
+
+    double sy = camera.tan_half_fov();
+    double sx = sy * width / double(height);
+
+    Vector<double, dim> local = camera.to_camera(center);
+
+    // the primary rays live in the camera hyperplane, only the slice of
+    // the ball in it can be hit
+    double r2 = radius2;
+    for(size_t k = 3; k < dim; k++){
+        r2 -= local[k] * local[k];
+    }
+    if(r2 <= 0){
+        return false;
+    }
+    double r = sqrt(r2);
+
+    // a ball projects on the (right, forward) and (up, forward) planes
+    // as disks of the same radius
+    double f = -local[2];
+    double xlo, xhi, ylo, yhi;
+    if(!slope_range(local[0], f, r, xlo, xhi)) {return false;}
+    if(!slope_range(local[1], f, r, ylo, yhi)) {return false;}
+
+    size_t i0, i1, j0, j1;
+    if(!pixel_range(xlo, xhi, sx, width, i0, i1)) {return false;}
+    if(!pixel_range(ylo, yhi, sy, height, j0, j1)) {return false;}
+
+    tx0 = i0 / TILE_SIZE;
+    tx1 = i1 / TILE_SIZE;
+    ty0 = j0 / TILE_SIZE;
+    ty1 = j1 / TILE_SIZE;
+    return true;
+}
+
+// the primary ray of pixel (i, j) in camera coordinates, see
+// Camera::ray_deltas
+template<size_t dim>
+V3d camera_ray(const Camera<dim>& camera, double i, double j){
+    double sy = camera.tan_half_fov();
+    double sx = sy * camera.width / double(camera.height);
+    return V3d(sx * (2 * (i + 0.5) / camera.width - 1), sy * (2 * (j + 0.5) / camera.height - 1), -1);
+}
+
+// the smallest cone around the tile axis containing the corner rays holds
+// every ray of the tile, the pixel centers lie in a rectangle
+template<size_t dim>
+void tile_cone(const Camera<dim>& camera, size_t tx, size_t ty, Tile& tile){
+    size_t i0 = tx * TILE_SIZE, i1 = std::min<size_t>(camera.width, i0 + TILE_SIZE) - 1;
+    size_t j0 = ty * TILE_SIZE, j1 = std::min<size_t>(camera.height, j0 + TILE_SIZE) - 1;
+
+    tile.cone_axis = camera_ray(camera, (i0 + i1) / 2., (j0 + j1) / 2.);
+    tile.cone_axis.normalize();
+
+    double cos_angle = 1;
+    for(size_t i : {i0, i1}){
+        for(size_t j : {j0, j1}){
+            V3d corner = camera_ray(camera, i, j);
+            corner.normalize();
+            cos_angle = std::min(cos_angle, tile.cone_axis.dot(corner));
+        }
+    }
+    tile.cone_angle = acos(std::max(-1., std::min(1., cos_angle)));
+}
+
+// conservative reject of a ball (center in camera coordinates) that no ray
+// of the cone can reach: the angle between the axis and the center is
+// larger than the cone plus the angular radius of the ball. The small
+// margin covers the rounding of the angles
+template<size_t dim>
+bool cone_misses(const Tile& tile, const Vector<double, dim>& local, double radius2){
+    double l2 = local.dot(local);
+    if(l2 <= radius2){
+        return false;
+    }
+
+    double l = sqrt(l2);
+    double cos_center = (tile.cone_axis[0] * local[0] + tile.cone_axis[1] * local[1] + tile.cone_axis[2] * local[2]) / l;
+    double center_angle = acos(std::max(-1., std::min(1., cos_center)));
+
+    return center_angle > tile.cone_angle + asin(sqrt(radius2 / l2)) + 1e-6;
+}
+
+// [ty0, ty1] restricted to the rows of the grid, false if none is left
+inline bool clip_rows(const TileGrid& grid, size_t& ty0, size_t& ty1){
+    ty0 = std::max(ty0, grid.ty0);
+    ty1 = std::min(ty1, grid.ty1 - 1);
+    return grid.ty1 > grid.ty0 && ty0 <= ty1;
+}
+
+// the tile rows [row0, row1) of the frame, every row by default
+template<size_t dim>
+void build_tiles(const Scene<dim>& scene, const Camera<dim>& camera, TileGrid& grid, size_t row0 = 0, size_t row1 = SIZE_MAX){
+    grid.ntiles_x = (camera.width + TILE_SIZE - 1) / TILE_SIZE;
+    grid.ntiles_y = (camera.height + TILE_SIZE - 1) / TILE_SIZE;
+    grid.ty1 = std::min(row1, grid.ntiles_y);
+    grid.ty0 = std::min(row0, grid.ty1);
+    grid.tiles.resize(grid.ntiles_x * grid.rows());
+    for(size_t tx = 0; tx < grid.ntiles_x; tx++){
+        for(size_t ty = grid.ty0; ty < grid.ty1; ty++){
+            Tile& t = grid.tile(tx, ty);
+            t.clear();
+            tile_cone(camera, tx, ty, t);
+        }
+    }
+
+    size_t tx0, tx1, ty0, ty1;
+
+    // the bounding box of the projection is refined by the tile cones,
+    // which drop the tiles near the corners of the box
+    for(size_t n = 0; n < scene.spheres.size(); n++){
+        const Sphere<dim>& sphere = scene.spheres[n];
+        if(!tile_range(sphere.center, sphere.radius2, camera, tx0, tx1, ty0, ty1)) {continue;}
+        if(!clip_rows(grid, ty0, ty1)) {continue;}
+
+        Vector<double, dim> local = camera.to_camera(sphere.center);
+        for(size_t tx = tx0; tx <= tx1; tx++){
+            for(size_t ty = ty0; ty <= ty1; ty++){
+                Tile& t = grid.tile(tx, ty);
+                if(!cone_misses(t, local, sphere.radius2)){
+                    t.spheres.push_back(n);
+                }
+            }
+        }
+    }
+
+    for(size_t n = 0; n < scene.boxes.size(); n++){
+        const Box<dim>& box = scene.boxes[n];
+        double r = box.bounding_radius();
+        if(!tile_range(box.center(), r * r, camera, tx0, tx1, ty0, ty1)) {continue;}
+        if(!clip_rows(grid, ty0, ty1)) {continue;}
+
+        Vector<double, dim> local = camera.to_camera(box.center());
+        for(size_t tx = tx0; tx <= tx1; tx++){
+            for(size_t ty = ty0; ty <= ty1; ty++){
+                Tile& t = grid.tile(tx, ty);
+                if(!cone_misses(t, local, r * r)){
+                    t.boxes.push_back(n);
+                }
+            }
+        }
+    }
+}
+
+
+/*******************************************************************************
+Renderer class
+    long lived render context, it owns the scene, the camera, the tile
+    lists, the framebuffer and the worker threads. Scene and camera are
+    changed in place between frames and render() reuses all the buffers,
+    so once the sizes are stable a frame does no heap allocation. The tiles
+    are traced either by the recursive trace() or by the wavefront engine
+*******************************************************************************/
+
+// recursive trace() per pixel or wavefront batches per tile
+enum class Engine {recursive, wavefront};
+
+template<size_t dim>
+class Renderer{
+private:
+    Scene<dim> world;
+    Camera<dim> cam;
+    Engine mode;
+
+    // the world with the spheres cut to the level of detail of the frame
+    SphereLod<dim> lod;
+    double lod_pixels;
+    Scene<dim> drawn;
+
+    TileGrid grid;
+    bmp::Image frame;
+    // image row of the first row of frame, not 0 for the strips
+    size_t frame_top;
+
+    // primary rays of the current frame, see Camera::ray_deltas
+    Vector<double, dim> d00, dx, dy;
+    OriginCache<dim> origin;
+    Lights<dim> lights;
+
+    // frames rendered so far, part of the sampler seeds
+    uint64_t frame_number;
+
+    ThreadPool pool;
+
+    // wavefront buffers and samplers, one per worker
+    std::vector<Wavefront<dim>> waves;
+    std::vector<Sampler> samplers;
+
+    // primary hits and linear color, kept if asked or for the denoiser
+    // and the temporal accumulation
+    AuxBuffers aux;
+    bool keep_aux;
+    bool denoising;
+    Denoiser filter;
+    bool accumulating;
+    Temporal<dim> history;
+
+    // set by another thread to stop the frame being rendered
+    const std::atomic<bool>* abort_flag;
+
+    // finished frames by input hash, see frame_cache()
+    FrameCache* cache;
+
+    bool aborted() const {return abort_flag && abort_flag->load(std::memory_order_relaxed);}
+
+    // the frame setup of begin_frame() and render_strips(): ray deltas,
+    // level of detail, primary origin and light lists
+    void prepare_frame(){
+        cam.ray_deltas(d00, dx, dy);
+        select_detail();
+        origin.build(traced(), cam.position);
+        lights.build(traced());
+    }
+
+    // the frame only depends on the input, the aux buffers and the
+    // history are filled by a render
+    bool cacheable() const {return cache && !keep_aux && !accumulating;}
+
+    static void hash_material(FrameHash& h, const Material& material){
+        for(size_t c = 0; c < 3; c++){
+            h.add(material.surface[c]);
+            h.add(material.emission[c]);
+        }
+        h.add(material.transparency);
+        h.add(material.reflection);
+    }
+
+    static void hash_vector(FrameHash& h, const Vector<double, dim>& v){
+        for(size_t k = 0; k < dim; k++){
+            h.add(v[k]);
+        }
+    }
+
+    // everything the pixels depend on
+    uint64_t frame_key() const {
+        FrameHash h;
+        h.add(RENDER_VERSION);
+        h.add(uint64_t(dim));
+        h.add(MAX_RAY_DEPTH);
+        h.add(RAY_BIAS);
+
+        h.add(uint64_t(world.spheres.size()));
+        for(const Sphere<dim>& s : world.spheres){
+            hash_vector(h, s.center);
+            h.add(s.radius);
+            hash_material(h, s);
+        }
+        h.add(uint64_t(world.planes.size()));
+        for(const Plane<dim>& p : world.planes){
+            hash_vector(h, p.n);
+            h.add(p.offset);
+            hash_material(h, p);
+        }
+        h.add(uint64_t(world.boxes.size()));
+        for(const Box<dim>& b : world.boxes){
+            hash_vector(h, b.lo);
+            hash_vector(h, b.hi);
+            hash_material(h, b);
+        }
+        if(world.cloud){
+            h.add(world.cloud->fingerprint());
+        }
+        h.add(lod_pixels);
+
+        hash_vector(h, cam.position);
+        for(size_t k = 0; k < dim; k++){
+            hash_vector(h, cam.axes[k]);
+        }
+        h.add(uint64_t(cam.width));
+        h.add(uint64_t(cam.height));
+        h.add(cam.fov);
+
+        h.add(uint64_t(mode));
+        h.add(uint64_t(lights.samples));
+        h.add(uint64_t(lights.area_samples));
+        h.add(uint64_t(lights.area_max_samples));
+        // the samplers are seeded with the frame number
+        if(lights.samples > 0 || lights.area_samples > 0){
+            h.add(frame_number);
+        }
+        h.add(uint64_t(denoising));
+        if(denoising){
+            h.add(uint64_t(filter.iterations));
+            h.add(double(filter.sigma_color));
+            h.add(double(filter.sigma_normal));
+            h.add(double(filter.sigma_depth));
+        }
+        return h.value();
+    }
+
+    bool use_aux() const {return keep_aux || denoising || accumulating;}
+
+    // cuts the spheres of the frame, the tree is rebuilt when they change
+    void select_detail(){
+        if(lod_pixels <= 0){
+            return;
+        }
+        if(!(lod.source() == world.spheres)){
+            lod.build(world.spheres);
+        }
+        drawn.spheres.clear();
+        drawn.planes = world.planes;
+        drawn.boxes = world.boxes;
+        drawn.cloud = world.cloud;
+        lod.cut(cam, lod_pixels, drawn.spheres);
+    }
+
+    // the framebuffer is written from aux once the frame is filtered
+    bool filtered() const {return denoising || accumulating;}
+
+    void store_aux(size_t i, size_t j, const Color& pixel, const PrimaryHit<dim>& first){
+        float rgb[3] = {float(pixel[0]), float(pixel[1]), float(pixel[2])};
+        float n[3] = {0, 0, 0};
+        float depth = INFINITY;
+        if(first.hit){
+            for(size_t k = 0; k < 3; k++){
+                n[k] = first.normal.dot(cam.axes[k]);
+            }
+            depth = first.hit.t;
+        }
+        bool diffuse = first.hit && material_class(hit_material(traced(), first.hit), 0) <= MaterialClass::emissive;
+        aux.set(i, cam.height - 1 - j, rgb, n, depth, object_id(first.hit), diffuse, first.depth);
+    }
+
+    void store(size_t i, size_t j, Color pixel){
+        // limit the color to a value between 0 and 1;
+        pixel.x(std::min(1., pixel.x()));
+        pixel.y(std::min(1., pixel.y()));
+        pixel.z(std::min(1., pixel.z()));
+
+
+        // convert the color to bmp color (8 bit per color)
+        bmp::Color bmppix(pixel * 255);
+
+        frame.pixelArray.set(i, cam.height - 1 - j - frame_top, bmppix);
+    }
+
+    void render_tile(size_t tile, size_t worker){
+        size_t tx = grid.tile_x(tile);
+        size_t ty = grid.tile_y(tile);
+
+        const Tile& candidates = grid.tiles[tile];
+        Sampler& sampler = samplers[worker];
+
+        size_t width = cam.width, height = cam.height;
+        size_t i0 = tx * TILE_SIZE, i1 = std::min<size_t>(width, i0 + TILE_SIZE);
+        size_t j0 = ty * TILE_SIZE, j1 = std::min<size_t>(height, j0 + TILE_SIZE);
+
+        for(size_t j = j0; j < j1; j++){
+            // the ray directions are linear in the pixel coordinates, so
+            // they are stepped along the row instead of recomputed
+            Vector<double, dim> rowdir = d00 + dy * double(j) + dx * double(i0);
+
+            for(size_t i = i0; i < i1; i++){
+                Vector<double, dim> raydir = rowdir;
+                raydir.normalize();
+
+                sampler.start(j * width + i, frame_number);
+                if(use_aux()){
+                    PrimaryHit<dim> first;
+                    Color pixel = trace(cam.position, raydir, traced(), 0, &candidates, &origin, &lights, &sampler, &first);
+                    store_aux(i, j, pixel, first);
+                    if(!filtered()){
+                        store(i, j, pixel);
+                    }
+                }
+                else{
+                    store(i, j, trace(cam.position, raydir, traced(), 0, &candidates, &origin, &lights, &sampler));
+                }
+
+                rowdir += dx;
+            }
+        }
+    }
+
+    // same tile as a wavefront batch, slot (i - i0) + (j - j0) * TILE_SIZE
+    void render_tile_wavefront(size_t tile, size_t worker){
+        size_t tx = grid.tile_x(tile);
+        size_t ty = grid.tile_y(tile);
+
+        size_t width = cam.width, height = cam.height;
+        size_t i0 = tx * TILE_SIZE, i1 = std::min<size_t>(width, i0 + TILE_SIZE);
+        size_t j0 = ty * TILE_SIZE, j1 = std::min<size_t>(height, j0 + TILE_SIZE);
+
+        Wavefront<dim>& wave = waves[worker];
+        RayBuffer<dim>& rays = wave.begin(TILE_SIZE * TILE_SIZE, grid.frame_tile(tile) * TILE_SIZE * TILE_SIZE, frame_number);
+
+        for(size_t j = j0; j < j1; j++){
+            Vector<double, dim> rowdir = d00 + dy * double(j) + dx * double(i0);
+
+            for(size_t i = i0; i < i1; i++){
+                Vector<double, dim> raydir = rowdir;
+                raydir.normalize();
+
+                rays.push(cam.position, raydir, Color(1), (i - i0) + (j - j0) * TILE_SIZE);
+
+                rowdir += dx;
+            }
+        }
+
+        wave.trace(traced(), &grid.tiles[tile], &origin, &lights, &samplers[worker], use_aux());
+
+        for(size_t j = j0; j < j1; j++){
+            for(size_t i = i0; i < i1; i++){
+                size_t slot = (i - i0) + (j - j0) * TILE_SIZE;
+                if(use_aux()){
+                    store_aux(i, j, wave.color(slot), wave.first_hit(slot));
+                }
+                if(!filtered()){
+                    store(i, j, wave.color(slot));
+                }
+            }
+        }
+    }
+
+    // the filtered linear color to the framebuffer, rows split in jobs
+    void store_filtered(){
+        auto job = [this](size_t y, size_t){
+            for(size_t x = 0; x < aux.width; x++){
+                const float* rgb = &aux.color[3 * (y * aux.width + x)];
+                store(x, cam.height - 1 - y, Color(rgb[0], rgb[1], rgb[2]));
+            }
+        };
+        pool.parallel_for(aux.height, job);
+    }
+
+public:
+    // nthreads is the number of threads rendering the tiles
+    Renderer(const Camera<dim>& camera = Camera<dim>(), size_t nthreads = 1, Engine engine = Engine::recursive) :
+        cam(camera),
+        mode(engine),
+        lod_pixels(0),
+        frame(0, 0), // sized by the first frame
+        frame_top(0),
+        frame_number(0),
+        pool(nthreads),
+        waves(pool.size()),
+        samplers(pool.size()),
+        keep_aux(false),
+        denoising(false),
+        accumulating(false),
+        abort_flag(nullptr),
+        cache(nullptr)
+        {}
+
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
+    Scene<dim>& scene() {return world;}
+    const Scene<dim>& scene() const {return world;}
+
+    Camera<dim>& camera() {return cam;}
+    const Camera<dim>& camera() const {return cam;}
+
+    size_t threads() const {return pool.size();}
+    // the workers of the tiles, free between frames (for the encoders)
+    ThreadPool& thread_pool() {return pool;}
+
+    Engine engine() const {return mode;}
+    void engine(Engine e) {mode = e;}
+
+    // transient memory of the wavefront workers, summed over the threads.
+    // The recursive engine keeps it on the stack
+    ArenaStats memory() const {
+        ArenaStats total;
+        for(const Wavefront<dim>& wave : waves){
+            total += wave.memory();
+        }
+        return total;
+    }
+
+    // shadow rays per diffuse hit, 0 (the default) evaluates every light
+    size_t light_samples() const {return lights.samples;}
+    void light_samples(size_t n) {lights.samples = n;}
+
+    // soft shadows from the light spheres, samples shadow rays per light
+    // and up to max_samples in the penumbra (4 * samples if 0). 0 samples
+    // goes back to point lights
+    void area_lights(size_t samples, size_t max_samples = 0){
+        lights.area_samples = samples;
+        lights.area_max_samples = max_samples ? max_samples : 4 * samples;
+    }
+    size_t area_samples() const {return lights.area_samples;}
+    size_t area_max_samples() const {return lights.area_max_samples;}
+
+    // the spheres covering less than pixels pixels are merged with their
+    // neighbors into proxies of averaged material (see SphereLod), for
+    // lattices too fine for the image. 0 (the default) traces them all
+    void level_of_detail(double pixels) {lod_pixels = pixels;}
+    double level_of_detail() const {return lod_pixels;}
+
+    // the scene traced by the last frame, the world with the spheres of
+    // the level of detail. The tiles and the aux object ids index it
+    const Scene<dim>& traced() const {return lod_pixels > 0 ? drawn : world;}
+
+    // keeps normal, depth and object id of the primary hits, the depth of
+    // the paths and the linear color of every pixel in aux_buffers()
+    void aux_buffers(bool on) {keep_aux = on;}
+    const AuxBuffers& aux_buffers() const {return aux;}
+
+    // filters the linear color with the denoiser before it's quantized,
+    // the aux buffers are kept and hold the filtered color
+    void denoise(bool on) {denoising = on;}
+    Denoiser& denoiser() {return filter;}
+
+    // blends every frame with the reprojected previous ones, for camera
+    // and object animations. The history is reset when switched on, the
+    // aux buffers are kept and hold the accumulated color
+    void temporal(bool on, size_t max_history = 16){
+        accumulating = on;
+        history.max_history = std::max<size_t>(1, max_history);
+        history.reset();
+    }
+    Temporal<dim>& temporal() {return history;}
+
+    // the last rendered frame
+    bmp::Image& image() {return frame;}
+
+    // while *flag is true render() skips the remaining tiles, the frame is
+    // left incomplete. nullptr (the default) can't be aborted
+    void abort_on(const std::atomic<bool>* flag) {abort_flag = flag;}
+
+    // the tiles of the frame, tile (tx, ty) covers the pixels
+    // [tx, tx + 1) * TILE_SIZE x [ty, ty + 1) * TILE_SIZE, ty from the bottom
+    const TileGrid& tiles() const {return grid;}
+
+    // frames rendered so far, the samplers of a frame are seeded with it
+    uint64_t frame_index() const {return frame_number;}
+    void frame_index(uint64_t n) {frame_number = n;}
+
+    // per frame setup of render(), needed before render_tiles()
+    void begin_frame(){
+        if(frame.width() != int(cam.width) || frame.height() != int(cam.height)){
+            frame = bmp::Image(cam.width, cam.height);
+        }
+        frame_top = 0;
+        prepare_frame();
+        build_tiles(traced(), cam, grid);
+        if(use_aux()){
+            aux.resize(cam.width, cam.height);
+        }
+    }
+
+    // renders the n tiles of the list in image(), the first n tiles if
+    // list is nullptr. The other pixels are left as they are and nothing
+    // is filtered, part of a frame started by begin_frame()
+    void render_tiles(const uint32_t* list, size_t n){
+        if(mode == Engine::wavefront){
+            auto job = [this, list](size_t k, size_t worker){ if(!aborted()) {render_tile_wavefront(list ? list[k] : k, worker);} };
+            pool.parallel_for(n, job);
+        }
+        else{
+            auto job = [this, list](size_t k, size_t worker){ if(!aborted()) {render_tile(list ? list[k] : k, worker);} };
+            pool.parallel_for(n, job);
+        }
+    }
+
+    // frames already in the cache are read instead of rendered, the others
+    // are added to it. Not used with the aux buffers or the temporal
+    // accumulation. nullptr (the default) renders every frame
+    void frame_cache(FrameCache* frames) {cache = frames;}
+
+    // renders the scene seen by the camera into the framebuffer
+    bmp::Image& render(){
+        if(frame.width() != int(cam.width) || frame.height() != int(cam.height)){
+            frame = bmp::Image(cam.width, cam.height);
+        }
+        frame_top = 0;
+
+        uint64_t key = 0;
+        if(cacheable()){
+            key = frame_key();
+            if(cache->get(key, frame)){
+                frame_number++;
+                return frame;
+            }
+        }
+
+        begin_frame();
+        render_tiles(nullptr, grid.tiles.size());
+        if(aborted()){
+            return frame;
+        }
+
+        // accumulated before the denoiser, so the history is the
+        // unfiltered color and the filter sees less noise every frame
+        if(accumulating){
+            history.accumulate(cam, traced(), aux, pool);
+        }
+        if(denoising){
+            filter.denoise(aux, pool);
+        }
+        if(filtered()){
+            store_filtered();
+        }
+        if(cacheable()){
+            cache->put(key, frame);
+        }
+        frame_number++;
+
+        return frame;
+    }
+
+    // renders the frame in strips of strip_rows rows (rounded up to whole
+    // tiles), bottom strip first, and streams each one to the bmp file, so
+    // the memory is bounded by the strip whatever the size of the image.
+    // overlay(strip, row0), if given, draws on every strip before it's
+    // written (see Glyphs::imprint), the strip holds the rows [row0, row0 +
+    // height) of the image, counted from the top like bmp::Image. The
+    // pixels are those of render(), without filtering, aux buffers or
+    // cache. image() holds the top strip afterwards. False if the frame was
+    // aborted (see abort_on()), the unfinished file is deleted then
+    bool render_strips(const std::string& filename, size_t strip_rows = 4 * TILE_SIZE,
+                       const std::function<void(bmp::Image&, size_t)>& overlay = nullptr){
+        if(use_aux()){
+            throw "Renderer: strips can't be filtered or keep the aux buffers";
+        }
+        size_t tile_rows = std::max<size_t>(1, (strip_rows + TILE_SIZE - 1) / TILE_SIZE);
+
+        bmp::StripWriter out(filename, cam.width, cam.height);
+        prepare_frame();
+
+        for(size_t j0 = 0; j0 < cam.height; j0 += tile_rows * TILE_SIZE){
+            size_t j1 = std::min<size_t>(cam.height, j0 + tile_rows * TILE_SIZE);
+            if(frame.width() != int(cam.width) || frame.height() != int(j1 - j0)){
+                frame = bmp::Image(cam.width, j1 - j0);
+            }
+            frame_top = cam.height - j1;
+
+            build_tiles(traced(), cam, grid, j0 / TILE_SIZE, j0 / TILE_SIZE + tile_rows);
+            render_tiles(nullptr, grid.tiles.size());
+            if(aborted()){
+                out.discard();
+                return false;
+            }
+
+            if(overlay){
+                overlay(frame, frame_top);
+            }
+            out.write(frame);
+        }
+        out.close();
+        frame_number++;
+        return true;
+    }
+};
+
+
+/*******************************************************************************
+render function
+    one shot render of the image seen by the camera, the scene is copied in
+    a temporary Renderer, use a Renderer directly for sequences. With a
+    cache the frames rendered before are read from it, with aux the
+    channels of the primary hits are filled in the same pass
+*******************************************************************************/
+
+template<size_t dim>
+bmp::Image render(const Scene<dim>& scene, const Camera<dim>& camera = Camera<dim>(), Engine engine = Engine::recursive, FrameCache* cache = nullptr){
+    Renderer<dim> renderer(camera, 1, engine);
+    renderer.scene() = scene;
+    renderer.frame_cache(cache);
+    return renderer.render();
+}
+
+template<size_t dim>
+bmp::Image render(const Scene<dim>& scene, const Camera<dim>& camera, AuxBuffers& aux, Engine engine = Engine::recursive){
+    Renderer<dim> renderer(camera, 1, engine);
+    renderer.scene() = scene;
+    renderer.aux_buffers(true);
+    bmp::Image img = renderer.render();
+    aux = renderer.aux_buffers();
+    return img;
+}
+
+template<size_t dim>
+bmp::Image render(const std::vector<Sphere<dim>>& spheres, const Camera<dim>& camera = Camera<dim>()){
+    return render(Scene<dim>(spheres), camera);
+}
+
+
+/*******************************************************************************
+hyperplane slice
+    intersects the N-D scene with the 3D hyperplane through the camera
+    spanned by its right, up and forward axes, which is where the rays of
+    render<dim>() live. A sphere at distance d from the hyperplane leaves a
+    3D sphere of radius sqrt(r^2 - d^2), spheres with d >= r don't appear
+    and are culled, hyperplanes leave planes and boxes boxes. The slice is
+    returned in camera coordinates and traced by the 3D kernel, so normals
+    and secondary rays stay inside the hyperplane (in the full N-D trace
+    they can leave it)
+*******************************************************************************/
+
+// the slice is written to sliced, whose lists keep their capacity. Boxes
+// stay axis aligned only if the camera x, y, z are the world ones
+template<size_t dim>
+void slice(const Scene<dim>& scene, const Camera<dim>& camera, Scene<3>& sliced){
+    sliced.clear();
+
+    for(const Sphere<dim>& sphere : scene.spheres){
+        Vector<double, dim> local = camera.to_camera(sphere.center);
+
+        // squared distance of the center from the hyperplane
+        double d2 = 0;
+        for(size_t k = 3; k < dim; k++){
+            d2 += local[k] * local[k];
+        }
+
+        if(d2 >= sphere.radius2){
+            continue;
+        }
+
+        V3d center(local[0], local[1], local[2]);
+        sliced.spheres.push_back(Sphere<3>(center, sqrt(sphere.radius2 - d2), sphere.surface, sphere.emission, sphere.transparency, sphere.reflection));
+    }
+
+    for(const Plane<dim>& plane : scene.planes){
+        // n . x = offset in camera coordinates, restricted to the first 3
+        V3d normal(plane.n.dot(camera.axes[0]), plane.n.dot(camera.axes[1]), plane.n.dot(camera.axes[2]));
+        double offset = plane.offset - plane.n.dot(camera.position);
+
+        // parallel to the slice: it either contains it or misses it
+        if(normal.length() < 1e-12){
+            continue;
+        }
+
+        V3d point = normal * (offset / normal.length_squared());
+        sliced.planes.push_back(Plane<3>(point, normal, plane.surface, plane.emission, plane.transparency, plane.reflection));
+    }
+
+    if(!scene.boxes.empty()){
+        for(size_t k = 0; k < 3; k++){
+            Vector<double, dim> axis;
+            axis[k] = 1;
+            if(!camera.axes[k].cmp_close(axis)){
+                throw "Slice: boxes need a camera aligned with the world x, y, z";
+            }
+        }
+    }
+
+    for(const Box<dim>& box : scene.boxes){
+        bool inside = true;
+        for(size_t k = 3; k < dim; k++){
+            inside = inside && camera.position[k] >= box.lo[k] && camera.position[k] <= box.hi[k];
+        }
+        if(!inside){
+            continue;
+        }
+
+        V3d lo(box.lo[0] - camera.position[0], box.lo[1] - camera.position[1], box.lo[2] - camera.position[2]);
+        V3d hi(box.hi[0] - camera.position[0], box.hi[1] - camera.position[1], box.hi[2] - camera.position[2]);
+        sliced.boxes.push_back(Box<3>(lo, hi, box.surface, box.emission, box.transparency, box.reflection));
+    }
+}
+
+template<size_t dim>
+Scene<3> slice(const Scene<dim>& scene, const Camera<dim>& camera){
+    Scene<3> sliced;
+    slice(scene, camera, sliced);
+    return sliced;
+}
+
+template<size_t dim>
+bmp::Image render_slice(const Scene<dim>& scene, const Camera<dim>& camera = Camera<dim>()){
+    return render<3>(slice(scene, camera), Camera<3>(camera.width, camera.height, camera.fov));
+}
+
+#endif // RAYTRACER_T
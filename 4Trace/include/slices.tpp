@@ -0,0 +1,206 @@
+#ifndef SLICES_T
+#define SLICES_T
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+
+#include "raytracer.tpp"
+#include "ImageOps.h"
+
+/*******************************************************************************
+slice batches
+    the cross sections of the N-D scene at several offsets w along the 4th
+    camera axis, slice k is render_slice() of the camera moved by
+    offsets[k] * axes[3]. The camera coordinates of the spheres are
+    computed once per batch, and each sphere becomes the interval of
+    offsets whose hyperplane cuts it. The intervals are sorted and swept
+    with the sorted offsets, so a slice only visits the spheres it cuts
+    and every sphere enters and leaves the sweep once. The slices share
+    one Renderer<3>, its threads and buffers, and are rendered with the
+    same frame number, so the light sampling doesn't change between them
+*******************************************************************************/
+
+template<size_t dim>
+class SliceBatch{
+    static_assert(dim >= 4, "SliceBatch: the slices are offset along the 4th axis");
+
+private:
+    // a sphere in camera coordinates, cut by the offsets in (lo, hi)
+    struct Span{
+        double lo, hi;
+        double w;  // coordinate along axes[3]
+        double r2; // radius2 less the squared coordinates past the 4th
+        uint32_t index;
+        V3d center;
+    };
+
+    Scene<dim> world;
+    Camera<dim> cam;
+    Renderer<3> slicer;
+
+    std::vector<Span> spans;
+    std::vector<uint32_t> active;
+
+    size_t visited;
+
+    // camera coordinates and intervals of the spheres, by start
+    void prepare(){
+        spans.clear();
+        for(size_t n = 0; n < world.spheres.size(); n++){
+            const Sphere<dim>& sphere = world.spheres[n];
+            Vector<double, dim> local = cam.to_camera(sphere.center);
+
+            double r2 = sphere.radius2;
+            for(size_t k = 4; k < dim; k++){
+                r2 -= local[k] * local[k];
+            }
+            if(r2 <= 0){
+                continue;
+            }
+
+            double half = sqrt(r2);
+            spans.push_back(Span{local[3] - half, local[3] + half, local[3], r2, uint32_t(n), V3d(local[0], local[1], local[2])});
+        }
+        std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b){return a.lo < b.lo;});
+    }
+
+    // the cross section at offset w, the spheres are those of the sweep
+    void slice_at(double w, Scene<3>& sliced){
+        sliced.clear();
+
+        // in scene order, as slice() has them
+        std::sort(active.begin(), active.end(), [&](uint32_t a, uint32_t b){return spans[a].index < spans[b].index;});
+        for(uint32_t s : active){
+            const Span& span = spans[s];
+            double d = span.w - w;
+            double r2 = span.r2 - d * d;
+            if(r2 <= 0){
+                continue;
+            }
+            const Sphere<dim>& sphere = world.spheres[span.index];
+            sliced.spheres.push_back(Sphere<3>(span.center, sqrt(r2), sphere.surface, sphere.emission, sphere.transparency, sphere.reflection));
+        }
+        visited += sliced.spheres.size();
+
+        Vector<double, dim> position = cam.position + cam.axes[3] * w;
+
+        for(const Plane<dim>& plane : world.planes){
+            V3d normal(plane.n.dot(cam.axes[0]), plane.n.dot(cam.axes[1]), plane.n.dot(cam.axes[2]));
+            double offset = plane.offset - plane.n.dot(position);
+            if(normal.length() < 1e-12){
+                continue;
+            }
+            V3d point = normal * (offset / normal.length_squared());
+            sliced.planes.push_back(Plane<3>(point, normal, plane.surface, plane.emission, plane.transparency, plane.reflection));
+        }
+
+        for(const Box<dim>& box : world.boxes){
+            bool inside = true;
+            for(size_t k = 3; k < dim; k++){
+                inside = inside && position[k] >= box.lo[k] && position[k] <= box.hi[k];
+            }
+            if(!inside){
+                continue;
+            }
+            V3d lo(box.lo[0] - position[0], box.lo[1] - position[1], box.lo[2] - position[2]);
+            V3d hi(box.hi[0] - position[0], box.hi[1] - position[1], box.hi[2] - position[2]);
+            sliced.boxes.push_back(Box<3>(lo, hi, box.surface, box.emission, box.transparency, box.reflection));
+        }
+    }
+
+public:
+    // nthreads is the number of threads rendering the tiles of a slice
+    SliceBatch(const Camera<dim>& camera = Camera<dim>(), size_t nthreads = 1, Engine engine = Engine::recursive) :
+        cam(camera),
+        slicer(Camera<3>(), nthreads, engine),
+        visited(0)
+        {}
+
+    Scene<dim>& scene() {return world;}
+    const Scene<dim>& scene() const {return world;}
+
+    Camera<dim>& camera() {return cam;}
+    const Camera<dim>& camera() const {return cam;}
+
+    // the 3D renderer of the slices, for its light settings and engine
+    Renderer<3>& renderer() {return slicer;}
+
+    // spheres in the slices of the last batch, summed over the slices
+    size_t spheres_visited() const {return visited;}
+
+    // the slices at the offsets, in the order of offsets
+    std::vector<bmp::Image> render(const std::vector<double>& offsets){
+        if(!world.boxes.empty()){
+            for(size_t k = 0; k < 3; k++){
+                Vector<double, dim> axis;
+                axis[k] = 1;
+                if(!cam.axes[k].cmp_close(axis)){
+                    throw "SliceBatch: boxes need a camera aligned with the world x, y, z";
+                }
+            }
+        }
+
+        prepare();
+        visited = 0;
+        active.clear();
+        slicer.camera() = Camera<3>(cam.width, cam.height, cam.fov);
+
+        std::vector<uint32_t> order(offsets.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b){return offsets[a] < offsets[b];});
+
+        std::vector<bmp::Image> images(offsets.size());
+        uint64_t frame = slicer.frame_index();
+        size_t next = 0;
+        for(uint32_t k : order){
+            double w = offsets[k];
+
+            while(next < spans.size() && spans[next].lo < w){
+                active.push_back(next++);
+            }
+            active.erase(std::remove_if(active.begin(), active.end(), [&](uint32_t s){return spans[s].hi <= w;}), active.end());
+
+            slice_at(w, slicer.scene());
+            slicer.frame_index(frame);
+            images[k] = slicer.render();
+        }
+        slicer.frame_index(frame + 1);
+
+        return images;
+    }
+};
+
+
+// the images on a grid of columns, left to right and top to bottom, with
+// gap pixels of background between them. The cells are as large as the
+// largest image
+inline bmp::Image contact_sheet(const std::vector<bmp::Image>& images, size_t columns, size_t gap = 2, bmp::Color background = bmp::Color(0)){
+    if(images.empty() || columns == 0){
+        throw "contact_sheet: no images or no columns";
+    }
+    columns = std::min(columns, images.size());
+    size_t rows = (images.size() + columns - 1) / columns;
+
+    size_t cell_w = 0, cell_h = 0;
+    for(const bmp::Image& img : images){
+        cell_w = std::max<size_t>(cell_w, img.width());
+        cell_h = std::max<size_t>(cell_h, img.height());
+    }
+
+    bmp::Image sheet(columns * cell_w + (columns - 1) * gap, rows * cell_h + (rows - 1) * gap);
+    for(int i = 0; i < sheet.width(); i++){
+        for(int j = 0; j < sheet.height(); j++){
+            sheet.pixelArray.set(i, j, background);
+        }
+    }
+
+    for(size_t n = 0; n < images.size(); n++){
+        imgops::blit(sheet, images[n], (n % columns) * (cell_w + gap), (n / columns) * (cell_h + gap));
+    }
+    return sheet;
+}
+
+#endif // SLICES_T
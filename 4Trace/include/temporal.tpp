@@ -0,0 +1,212 @@
+#ifndef TEMPORAL_T
+#define TEMPORAL_T
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+#include "vec.tpp"
+#include "camera.tpp"
+#include "primitives.tpp"
+#include "Denoiser.h"
+#include "ThreadPool.h"
+
+/*******************************************************************************
+Temporal class
+    accumulates the frames of a sequence. The primary hit of every pixel
+    is rebuilt from its depth and projected into the previous camera, if
+    the history pixel there saw the same object at the expected distance
+    its color is blended with the new one, so a static region converges
+    like a render with many samples. The history is rejected when:
+        the point wasn't in the previous view (or its hyperplane)
+        the history shows another object or depth (disocclusion)
+        the object itself changed (moved, resized or new material)
+    and everything is dropped when a light, the image size or the number
+    of objects changes. The blend is a running mean capped to max_history
+    frames, so the shadows of moving objects fade out instead of sticking
+*******************************************************************************/
+
+template<size_t dim>
+class Temporal{
+private:
+    size_t width = 0, height = 0;
+    bool valid = false;
+
+    // history, same layout as AuxBuffers
+    std::vector<float> color;
+    std::vector<float> depth;
+    std::vector<uint64_t> id;
+    std::vector<uint16_t> count;
+    std::vector<uint16_t> next_count;
+
+    // pixels of each row taken from the history, kept between frames
+    std::vector<size_t> row_reused;
+
+    // what the history was rendered with
+    Camera<dim> camera;
+    Scene<dim> scene;
+
+    // objects that differ from the history, by shape and index
+    std::vector<uint8_t> changed_spheres, changed_planes, changed_boxes;
+
+    size_t reused = 0;
+
+    template<typename T>
+    static void compare(const std::vector<T>& previous, const std::vector<T>& current, std::vector<uint8_t>& changed){
+        changed.resize(current.size());
+        for(size_t i = 0; i < current.size(); i++){
+            changed[i] = !(previous[i] == current[i]);
+        }
+    }
+
+    bool changed(uint64_t object) const {
+        size_t index = id_index(object);
+        switch(id_shape(object)){
+            case Shape::sphere: return changed_spheres[index];
+            case Shape::plane:  return changed_planes[index];
+            case Shape::box:    return changed_boxes[index];
+            default:            return false;
+        }
+    }
+
+    // true if the history can't be used at all for the new frame
+    bool must_reset(const Scene<dim>& world, const AuxBuffers& aux) const {
+        if(!valid || aux.width != width || aux.height != height){
+            return true;
+        }
+        if(world.spheres.size() != scene.spheres.size() ||
+           world.planes.size() != scene.planes.size() ||
+           world.boxes.size() != scene.boxes.size() || world.cloud != scene.cloud){
+            return true;
+        }
+        // the lights change the shading of everything
+        for(size_t i = 0; i < world.spheres.size(); i++){
+            bool light = !(world.spheres[i].emission == Color(0)) || !(scene.spheres[i].emission == Color(0));
+            if(light && !(world.spheres[i] == scene.spheres[i])){
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // history pixel seen by pixel (x, y) of the new frame, false if rejected
+    bool reproject(const Camera<dim>& cam, const Vector<double, dim>& raydir, const AuxBuffers& aux, size_t p, size_t& q) const {
+        Vector<double, dim> phit = cam.position + raydir * double(aux.depth[p]);
+        Vector<double, dim> local = camera.to_camera(phit);
+
+        double distance = (phit - camera.position).length();
+
+        // behind the previous camera or out of its hyperplane
+        double f = -local[2];
+        if(f <= 0){
+            return false;
+        }
+        for(size_t k = 3; k < dim; k++){
+            if(std::fabs(local[k]) > 1e-3 * distance){
+                return false;
+            }
+        }
+
+        double sy = camera.tan_half_fov();
+        double sx = sy * camera.width / double(camera.height);
+
+        double pi = (local[0] / f / sx + 1) * camera.width / 2 - 0.5;
+        double pj = (local[1] / f / sy + 1) * camera.height / 2 - 0.5;
+        long i = std::lround(pi);
+        long j = std::lround(pj);
+        if(i < 0 || j < 0 || i >= long(width) || j >= long(height)){
+            return false;
+        }
+
+        q = (height - 1 - j) * width + i;
+        if(id[q] != aux.id[p] || changed(aux.id[p])){
+            return false;
+        }
+        return std::fabs(depth[q] - distance) <= 0.02 * distance;
+    }
+
+    void keep(const Camera<dim>& cam, const Scene<dim>& world, const AuxBuffers& aux){
+        color = aux.color;
+        depth = aux.depth;
+        id = aux.id;
+        camera = cam;
+        scene = world;
+        valid = true;
+    }
+
+public:
+    // frames a pixel can average at most
+    size_t max_history;
+
+    Temporal(size_t max_history = 16) : max_history(max_history) {}
+
+    // forgets the history, the next frame starts over
+    void reset() {valid = false;}
+
+    // pixels that reused their history in the last frame
+    size_t reused_pixels() const {return reused;}
+
+    // blends the history into aux.color and keeps the result as the new
+    // history, aux holds the frame rendered with cam and world
+    void accumulate(const Camera<dim>& cam, const Scene<dim>& world, AuxBuffers& aux, ThreadPool& pool){
+        if(must_reset(world, aux)){
+            width = aux.width;
+            height = aux.height;
+            count.assign(width * height, 1);
+            reused = 0;
+            keep(cam, world, aux);
+            return;
+        }
+
+        compare(scene.spheres, world.spheres, changed_spheres);
+        compare(scene.planes, world.planes, changed_planes);
+        compare(scene.boxes, world.boxes, changed_boxes);
+
+        Vector<double, dim> d00, dx, dy;
+        cam.ray_deltas(d00, dx, dy);
+
+        next_count.resize(width * height);
+        row_reused.assign(height, 0);
+
+        auto job = [&](size_t y, size_t){
+            size_t j = height - 1 - y;
+            for(size_t x = 0; x < width; x++){
+                size_t p = y * width + x;
+                next_count[p] = 1;
+
+                // the background doesn't move and isn't noisy
+                if(aux.id[p] == 0){
+                    continue;
+                }
+
+                Vector<double, dim> raydir = d00 + dx * double(x) + dy * double(j);
+                raydir.normalize();
+
+                size_t q;
+                if(!reproject(cam, raydir, aux, p, q)){
+                    continue;
+                }
+
+                size_t n = std::min<size_t>(count[q], max_history - 1);
+                float w = 1.f / (n + 1);
+                for(size_t c = 0; c < 3; c++){
+                    aux.color[3 * p + c] = color[3 * q + c] + (aux.color[3 * p + c] - color[3 * q + c]) * w;
+                }
+                next_count[p] = n + 1;
+                row_reused[y]++;
+            }
+        };
+        pool.parallel_for(height, job);
+
+        reused = 0;
+        for(size_t r : row_reused){
+            reused += r;
+        }
+
+        std::swap(count, next_count);
+        keep(cam, world, aux);
+    }
+};
+
+#endif // TEMPORAL_T
@@ -0,0 +1,54 @@
+#include "Arena.h"
+
+#include <algorithm>
+
+using namespace std;
+
+
+ArenaStats& ArenaStats::operator+=(const ArenaStats& other){
+    used += other.used;
+    peak += other.peak;
+    capacity += other.capacity;
+    system_allocations += other.system_allocations;
+    return *this;
+}
+
+
+Arena::Arena(size_t initial) :
+    offset(0),
+    retired(0),
+    initial(initial)
+    {}
+
+void Arena::grow(size_t bytes){
+    size_t last = 0;
+    if(!blocks.empty()){
+        last = blocks.back().size;
+        retired += offset;
+    }
+    size_t size = max(bytes, max(initial, 2 * last));
+
+    blocks.push_back(Block{unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+    offset = 0;
+    usage.capacity += size;
+    usage.system_allocations++;
+}
+
+void Arena::reset(){
+    if(blocks.size() > 1){
+        // one block for the peak, with some room for the alignment
+        size_t size = usage.peak + usage.peak / 8;
+        blocks.clear();
+        usage.capacity = 0;
+        retired = 0;
+        grow(size);
+    }
+    offset = 0;
+    retired = 0;
+}
+
+ArenaStats Arena::stats() const{
+    ArenaStats s = usage;
+    s.used = retired + offset;
+    return s;
+}
@@ -0,0 +1,402 @@
+#include "Benchmark.h"
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <cstdio>
+
+#include <bmp.h>
+#include <Encoder.h>
+#include <raytracer.tpp>
+#include <mat.tpp>
+#include <Sampler.h>
+
+using namespace std;
+
+
+// test pattern with smooth gradients and a few hard edges, so that the
+// compressing encoders see something similar to a render
+static bmp::Image test_image(size_t width, size_t height){
+    bmp::Image img(width, height);
+    for(size_t i = 0; i < width; i++){
+        for(size_t j = 0; j < height; j++){
+            uint8_t r = 255 * i / width;
+            uint8_t g = 255 * j / height;
+            uint8_t b = ((i / 64 + j / 64) % 2) ? 200 : 50;
+            img.pixelArray.set(i, j, bmp::Color(r, g, b));
+        }
+    }
+    return img;
+}
+
+
+void Benchmark::bench_encoders(size_t width, size_t height, size_t repeats){
+    using clock = chrono::steady_clock;
+
+    bmp::Image img = test_image(width, height);
+    double megabytes = 3. * width * height / (1024. * 1024.);
+
+    size_t hw_threads = max(1u, thread::hardware_concurrency());
+    vector<size_t> thread_counts = {1};
+    if(hw_threads > 1){
+        thread_counts.push_back(hw_threads);
+    }
+
+    cout << "--- Encoder throughput " << width << "x" << height << " ---" << endl;
+
+    for(string ext : {"bmp", "ppm", "qoi", "png"}){
+        for(size_t nthreads : thread_counts){
+            ThreadPool pool(nthreads);
+            unique_ptr<enc::Encoder> encoder = enc::from_filename("." + ext, &pool);
+
+            enc::Bytes out;
+            // warmup, also sizes the output buffer
+            encoder->encode(img, out);
+
+            double best = INFINITY;
+            for(size_t r = 0; r < repeats; r++){
+                clock::time_point start = clock::now();
+                encoder->encode(img, out);
+                double elapsed = chrono::duration<double>(clock::now() - start).count();
+                best = min(best, elapsed);
+            }
+
+            cout << setw(4) << ext << " threads: " << setw(2) << nthreads
+                 << " time: " << setw(8) << fixed << setprecision(2) << best * 1000 << " ms"
+                 << " throughput: " << setw(8) << megabytes / best << " MB/s"
+                 << " size: " << setw(8) << out.size() / 1024 << " kB" << endl;
+        }
+    }
+
+    // encode + disk write, the file system is part of the cost
+    ThreadPool pool(hw_threads);
+    for(string ext : {"bmp", "ppm", "qoi", "png"}){
+        unique_ptr<enc::Encoder> encoder = enc::from_filename("." + ext, &pool);
+        string filename = "bench_encoder." + ext;
+
+        clock::time_point start = clock::now();
+        encoder->write(img, filename);
+        double elapsed = chrono::duration<double>(clock::now() - start).count();
+
+        cout << setw(4) << ext << " write to " << filename << ": "
+             << setw(8) << elapsed * 1000 << " ms" << endl;
+    }
+}
+
+
+// the animation scene with a few more diffuse spheres
+static Scene<4> bench_scene(){
+    Scene<4> scene;
+    scene.planes.push_back(Plane<4>(V4d(0, -4, 0, 0), V4d(0, 1, 0, 0), Color(0, 1, 1), Color(0), 0, 0));
+    scene.spheres.push_back(Sphere<4>(V4d(0, 20, -20, 0), 3, Color(0), Color(3), 0, 0));
+    scene.spheres.push_back(Sphere<4>(V4d(-5, 0, -30, 0), 4, Color(1, 0, 0), Color(0), 0, 0));
+    scene.spheres.push_back(Sphere<4>(V4d(5, -1, -15, 0), 2, Color(0, 0, 1), Color(0), 0, 0));
+    scene.spheres.push_back(Sphere<4>(V4d(0, 0, -20, 0.5), 2.5, Color(1, 1, 1), Color(0), 1.5, .1));
+    scene.spheres.push_back(Sphere<4>(V4d(8, 1, -28, 0), 3, Color(0.9, 0.8, 0.5), Color(0), 0, 0.6));
+    for(int k = 0; k < 8; k++){
+        scene.spheres.push_back(Sphere<4>(V4d(-12 + 3 * k, -3, -12 - 2 * k, 0), 1, Color(0.2 + 0.1 * k, 0.5, 0.3), Color(0), 0, 0));
+    }
+    return scene;
+}
+
+
+void Benchmark::bench_render(size_t width, size_t height, size_t repeats){
+    using clock = chrono::steady_clock;
+
+    size_t hw_threads = max(1u, thread::hardware_concurrency());
+    vector<size_t> thread_counts = {1};
+    if(hw_threads > 1){
+        thread_counts.push_back(hw_threads);
+    }
+
+    cout << "--- Render time " << width << "x" << height << " ---" << endl;
+
+    for(Engine engine : {Engine::recursive, Engine::wavefront}){
+        for(size_t nthreads : thread_counts){
+            Renderer<4> renderer(Camera<4>(width, height), nthreads, engine);
+            renderer.scene() = bench_scene();
+
+            // warmup, also sizes the buffers
+            renderer.render();
+
+            double best = INFINITY;
+            for(size_t r = 0; r < repeats; r++){
+                clock::time_point start = clock::now();
+                renderer.render();
+                double elapsed = chrono::duration<double>(clock::now() - start).count();
+                best = min(best, elapsed);
+            }
+
+            cout << setw(9) << (engine == Engine::wavefront ? "wavefront" : "recursive")
+                 << " threads: " << setw(2) << nthreads
+                 << " time: " << setw(8) << fixed << setprecision(2) << best * 1000 << " ms"
+                 << " rate: " << setw(8) << width * height / best / 1e6 << " Mpixel/s" << endl;
+        }
+    }
+}
+
+
+// frame time against the number of lights, every light against a fixed
+// number of sampled ones
+void Benchmark::bench_lights(size_t width, size_t height, size_t repeats){
+    using clock = chrono::steady_clock;
+
+    cout << "--- Light scaling " << width << "x" << height << " ---" << endl;
+
+    for(size_t nlights : {1, 4, 16, 64}){
+        for(size_t samples : {0, 2}){
+            Renderer<3> renderer(Camera<3>(width, height));
+            renderer.light_samples(samples);
+
+            Scene<3>& scene = renderer.scene();
+            scene.planes.push_back(Plane<3>(V3d(0, -4, 0), V3d(0, 1, 0), Color(0.8), Color(0), 0, 0));
+            scene.spheres.push_back(Sphere<3>(V3d(-4, -1, -20), 3, Color(1, 0.3, 0.3), Color(0), 0, 0));
+            scene.spheres.push_back(Sphere<3>(V3d(4, -2, -16), 2, Color(0.3, 0.3, 1), Color(0), 0, 0.5));
+            for(size_t k = 0; k < nlights; k++){
+                double x = -20 + 40. * k / max<size_t>(1, nlights - 1);
+                scene.spheres.push_back(Sphere<3>(V3d(x, 10, -10 - (k % 4) * 8.), 0.5, Color(0), Color(3. / nlights), 0, 0));
+            }
+
+            renderer.render();
+
+            double best = INFINITY;
+            for(size_t r = 0; r < repeats; r++){
+                clock::time_point start = clock::now();
+                renderer.render();
+                double elapsed = chrono::duration<double>(clock::now() - start).count();
+                best = min(best, elapsed);
+            }
+
+            cout << "lights: " << setw(3) << nlights
+                 << " samples: " << setw(3) << (samples ? numtostr(samples) : "all")
+                 << " time: " << setw(8) << fixed << setprecision(2) << best * 1000 << " ms" << endl;
+        }
+    }
+}
+
+
+/*******************************************************************************
+primitive timings
+    a case is timed in samples, each sample calls it often enough to last
+    about 50 us so the clock resolution doesn't show, and is reported per
+    call. The inputs cycle through a table of random values and the
+    results are summed into a volatile, so the compiler can neither hoist
+    nor drop the calls
+*******************************************************************************/
+
+struct Timing{
+    string name;
+    string param;           // dimension or size of the case
+    double median, p99, mad; // ns per call
+    size_t samples, calls;  // calls per sample
+    double bytes;           // per call, for the throughput
+};
+
+static volatile double sink;
+
+static const size_t INPUTS = 256;
+
+// seconds per call of calls calls
+template<typename F>
+static double run(F& f, size_t calls){
+    using clock = chrono::steady_clock;
+
+    double sum = 0;
+    clock::time_point start = clock::now();
+    for(size_t i = 0; i < calls; i++){
+        sum += f(i);
+    }
+    double elapsed = chrono::duration<double>(clock::now() - start).count();
+    sink = sum;
+    return elapsed / calls;
+}
+
+template<typename F>
+static Timing measure(const string& name, const string& param, F f, size_t samples, double bytes = 0){
+    size_t calls = 1;
+    while(calls < (1 << 24) && run(f, calls) * calls < 50e-6){
+        calls *= 2;
+    }
+
+    // warmup, the caches and the branch predictors see the case
+    for(size_t w = 0; w < max<size_t>(3, samples / 10); w++){
+        run(f, calls);
+    }
+
+    vector<double> times(samples);
+    for(double& t : times){
+        t = run(f, calls) * 1e9;
+    }
+    sort(times.begin(), times.end());
+
+    Timing timing{name, param, times[samples / 2], times[(samples * 99 + 99) / 100 - 1], 0, samples, calls, bytes};
+
+    vector<double> deviations(samples);
+    for(size_t k = 0; k < samples; k++){
+        deviations[k] = fabs(times[k] - timing.median);
+    }
+    sort(deviations.begin(), deviations.end());
+    timing.mad = deviations[samples / 2];
+
+    return timing;
+}
+
+template<size_t dim>
+static vector<Vector<double, dim>> random_vectors(Sampler& sampler, double lo, double hi){
+    vector<Vector<double, dim>> list(INPUTS);
+    for(Vector<double, dim>& v : list){
+        for(size_t k = 0; k < dim; k++){
+            v[k] = lo + (hi - lo) * sampler.next();
+        }
+    }
+    return list;
+}
+
+template<size_t dim>
+static void bench_vectors(vector<Timing>& timings, size_t samples){
+    Sampler sampler(dim);
+    vector<Vector<double, dim>> a = random_vectors<dim>(sampler, 0.5, 2);
+    vector<Vector<double, dim>> b = random_vectors<dim>(sampler, 0.5, 2);
+    string param = numtostr(dim);
+
+    timings.push_back(measure("dot", param, [&](size_t i){
+        return a[i % INPUTS].dot(b[i % INPUTS]);
+    }, samples));
+
+    timings.push_back(measure("length_squared", param, [&](size_t i){
+        return a[i % INPUTS].length_squared();
+    }, samples));
+
+    timings.push_back(measure("normalize", param, [&](size_t i){
+        Vector<double, dim> v = a[i % INPUTS];
+        v.normalize();
+        return v[0];
+    }, samples));
+
+    // rays from the origin, about half of them hit
+    vector<Sphere<dim>> spheres;
+    vector<Vector<double, dim>> directions = random_vectors<dim>(sampler, -1, 1);
+    for(size_t n = 0; n < INPUTS; n++){
+        directions[n][0] = 4;
+        directions[n].normalize();
+        Vector<double, dim> center = random_vectors<dim>(sampler, -1, 1)[0];
+        center[0] = 10;
+        spheres.push_back(Sphere<dim>(center, 1, Color(1), Color(0), 0, 0));
+    }
+    Vector<double, dim> origin;
+
+    timings.push_back(measure("sphere_intersect", param, [&](size_t i){
+        double t0 = 0, t1 = 0;
+        return spheres[i % INPUTS].intersect(origin, directions[(i * 7) % INPUTS], t0, t1) ? t0 : 0.;
+    }, samples));
+}
+
+static void bench_matrices(vector<Timing>& timings, size_t samples){
+    Sampler sampler(1);
+
+    for(size_t n : {4, 16, 64}){
+        Matrix<double> a(n, n), b(n, n);
+        for(size_t i = 0; i < n; i++){
+            for(size_t j = 0; j < n; j++){
+                a.set(i, j, sampler.next());
+                b.set(i, j, sampler.next());
+            }
+        }
+        string param = numtostr(n) + "x" + numtostr(n);
+
+        timings.push_back(measure("matrix_multiply", param, [&](size_t){
+            return (a * b).get(0, 0);
+        }, samples));
+
+        timings.push_back(measure("matrix_transpose", param, [&](size_t){
+            return a.transpose().get(0, n - 1);
+        }, samples));
+    }
+
+    Matrix44<double> mat;
+    for(size_t i = 0; i < 4; i++){
+        for(size_t j = 0; j < 4; j++){
+            mat.set(i, j, sampler.next());
+        }
+    }
+    vector<V3d> points;
+    for(size_t n = 0; n < INPUTS; n++){
+        points.push_back(V3d(sampler.next(), sampler.next(), sampler.next()));
+    }
+
+    timings.push_back(measure("v3_times_matrix44", "4x4", [&](size_t i){
+        return (points[i % INPUTS] * mat)[0];
+    }, samples));
+}
+
+static void bench_images(vector<Timing>& timings, size_t samples){
+    string filename = "bench_primitives.bmp";
+
+    for(pair<size_t, size_t> size : {make_pair(256, 256), make_pair(1024, 768), make_pair(1920, 1080)}){
+        bmp::Image img = test_image(size.first, size.second);
+        string param = numtostr(size.first) + "x" + numtostr(size.second);
+        double bytes = 3. * size.first * size.second;
+
+        timings.push_back(measure("image_write", param, [&](size_t){
+            img.write(filename);
+            return 0.;
+        }, samples, bytes));
+
+        timings.push_back(measure("image_read", param, [&](size_t){
+            bmp::Image read(filename);
+            return double(read.width());
+        }, samples, bytes));
+    }
+    remove(filename.c_str());
+}
+
+
+void Benchmark::bench_primitives(const string& json, size_t samples){
+    samples = max<size_t>(samples, 1);
+    vector<Timing> timings;
+
+    bench_vectors<2>(timings, samples);
+    bench_vectors<3>(timings, samples);
+    bench_vectors<4>(timings, samples);
+    bench_vectors<8>(timings, samples);
+    bench_matrices(timings, samples);
+    bench_images(timings, samples);
+
+    cout << "--- Primitives, " << samples << " samples, ns per call ---" << endl;
+    for(const Timing& t : timings){
+        cout << setw(18) << t.name << " " << setw(9) << t.param
+             << " median: " << setw(12) << fixed << setprecision(2) << t.median
+             << " p99: " << setw(12) << t.p99
+             << " mad: " << setw(10) << t.mad;
+        if(t.bytes > 0){
+            cout << " throughput: " << setw(8) << t.bytes / t.median * 1e9 / (1024. * 1024.) << " MB/s";
+        }
+        cout << endl;
+    }
+
+    if(json.empty()){
+        return;
+    }
+
+    ofstream out(json);
+    out << setprecision(6) << fixed;
+    out << "{\n  \"samples\": " << samples << ",\n  \"unit\": \"ns\",\n  \"results\": [\n";
+    for(size_t k = 0; k < timings.size(); k++){
+        const Timing& t = timings[k];
+        out << "    {\"name\": \"" << t.name << "\", \"param\": \"" << t.param << "\""
+            << ", \"median\": " << t.median << ", \"p99\": " << t.p99 << ", \"mad\": " << t.mad
+            << ", \"calls\": " << t.calls;
+        if(t.bytes > 0){
+            out << ", \"mb_per_s\": " << t.bytes / t.median * 1e9 / (1024. * 1024.);
+        }
+        out << "}" << (k + 1 < timings.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+
+    if(!out){
+        throw ios_base::failure("Benchmark: writing " + json + " went wrong");
+    }
+}
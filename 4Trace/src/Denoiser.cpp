@@ -0,0 +1,201 @@
+#include "Denoiser.h"
+
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <ios>
+
+using namespace std;
+
+
+void AuxBuffers::resize(size_t w, size_t h){
+    width = w;
+    height = h;
+    color.resize(3 * w * h);
+    normal.resize(3 * w * h);
+    depth.resize(w * h);
+    id.resize(w * h);
+    diffuse.resize(w * h);
+    ray_depth.resize(w * h);
+}
+
+template<typename T>
+static void write_plane(ofstream& out, const vector<T>& plane){
+    out.write(reinterpret_cast<const char*>(plane.data()), plane.size() * sizeof(T));
+}
+
+void AuxBuffers::write(const string& filename) const{
+    ofstream out(filename, ios::binary);
+    if(!out){
+        throw ios_base::failure("AuxBuffers: opening " + filename + " went wrong");
+    }
+    uint32_t size[2] = {uint32_t(width), uint32_t(height)};
+    out.write("4TAUX2\n", 7);
+    out.write(reinterpret_cast<const char*>(size), sizeof(size));
+    write_plane(out, color);
+    write_plane(out, normal);
+    write_plane(out, depth);
+    write_plane(out, id);
+    write_plane(out, ray_depth);
+    write_plane(out, diffuse);
+    if(!out){
+        throw ios_base::failure("AuxBuffers: writing " + filename + " went wrong");
+    }
+}
+
+// channels floats per pixel, PFM rows go from the bottom
+template<typename T>
+static void write_pfm_file(const string& filename, const vector<T>& plane, size_t channels, size_t width, size_t height){
+    ofstream out(filename, ios::binary);
+    if(!out){
+        throw ios_base::failure("AuxBuffers: opening " + filename + " went wrong");
+    }
+    // a negative scale is little endian
+    uint16_t probe = 1;
+    bool little = *reinterpret_cast<uint8_t*>(&probe) == 1;
+    out << (channels == 3 ? "PF" : "Pf") << "\n" << width << " " << height << "\n" << (little ? "-1.0" : "1.0") << "\n";
+
+    vector<float> row(channels * width);
+    for(size_t y = height; y-- > 0;){
+        for(size_t k = 0; k < row.size(); k++){
+            row[k] = float(plane[y * row.size() + k]);
+        }
+        out.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(float));
+    }
+    if(!out){
+        throw ios_base::failure("AuxBuffers: writing " + filename + " went wrong");
+    }
+}
+
+void AuxBuffers::write_pfm(const string& prefix) const{
+    write_pfm_file(prefix + "_color.pfm", color, 3, width, height);
+    write_pfm_file(prefix + "_normal.pfm", normal, 3, width, height);
+    write_pfm_file(prefix + "_depth.pfm", depth, 1, width, height);
+    // a float holds 24 bits exactly, so the id goes as the shape, the low
+    // 24 bits of the index and the bits above them
+    vector<float> split(3 * id.size());
+    for(size_t p = 0; p < id.size(); p++){
+        uint64_t index = id[p] & 0xFFFFFFFFFFFFFF;
+        split[3 * p] = float(id[p] >> 56);
+        split[3 * p + 1] = float(index & 0xFFFFFF);
+        split[3 * p + 2] = float(index >> 24);
+    }
+    write_pfm_file(prefix + "_id.pfm", split, 3, width, height);
+    write_pfm_file(prefix + "_ray_depth.pfm", ray_depth, 1, width, height);
+}
+
+
+void Denoiser::pass(const AuxBuffers& aux, const float* in, float* out, size_t step, size_t row_begin, size_t row_end) const{
+    // B3 spline taps for the offsets 0, 1, 2
+    constexpr float kernel[3] = {3.f / 8, 1.f / 4, 1.f / 16};
+
+    const float* normal = aux.normal.data();
+    const float* depth = aux.depth.data();
+    const uint64_t* id = aux.id.data();
+    const uint8_t* diffuse = aux.diffuse.data();
+    const float* lum = luminance.data();
+    const float* table = normal_weight.data();
+
+    int width = aux.width, height = aux.height;
+    int s = step;
+
+    float inv_color = float(step) / sigma_color;
+
+    for(int y = row_begin; y < int(row_end); y++){
+        for(int x = 0; x < width; x++){
+            size_t p = size_t(y) * width + x;
+
+            // nothing to denoise on the background and the mirrors
+            if(id[p] == 0 || !diffuse[p]){
+                out[3 * p] = in[3 * p];
+                out[3 * p + 1] = in[3 * p + 1];
+                out[3 * p + 2] = in[3 * p + 2];
+                continue;
+            }
+
+            float np0 = normal[3 * p], np1 = normal[3 * p + 1], np2 = normal[3 * p + 2];
+            float zp = depth[p];
+            float lp = lum[p];
+            float inv_depth = 1 / (sigma_depth * zp * s + 1e-6f);
+
+            float r = 0, g = 0, b = 0, wsum = 0;
+
+            for(int dy = -2; dy <= 2; dy++){
+                int qy = y + dy * s;
+                if(qy < 0 || qy >= height) {continue;}
+                float ky = kernel[abs(dy)];
+
+                for(int dx = -2; dx <= 2; dx++){
+                    int qx = x + dx * s;
+                    if(qx < 0 || qx >= width) {continue;}
+
+                    size_t q = size_t(qy) * width + qx;
+                    if(id[q] != id[p] || !diffuse[q]) {continue;}
+
+                    float cosine = np0 * normal[3 * q] + np1 * normal[3 * q + 1] + np2 * normal[3 * q + 2];
+                    if(cosine <= 0) {continue;}
+
+                    // pow(cosine, sigma_normal), linear between the entries
+                    float f = min(cosine, 1.f) * NORMAL_STEPS;
+                    size_t k = size_t(f);
+                    float wn = table[k] + (f - k) * (table[k + 1] - table[k]);
+
+                    float w = ky * kernel[abs(dx)] * wn *
+                              exp(-fabs(zp - depth[q]) * inv_depth - fabs(lp - lum[q]) * inv_color);
+
+                    r += w * in[3 * q];
+                    g += w * in[3 * q + 1];
+                    b += w * in[3 * q + 2];
+                    wsum += w;
+                }
+            }
+
+            // the center tap always counts, wsum > 0
+            out[3 * p] = r / wsum;
+            out[3 * p + 1] = g / wsum;
+            out[3 * p + 2] = b / wsum;
+        }
+    }
+}
+
+void Denoiser::denoise(AuxBuffers& aux, ThreadPool& pool){
+    scratch.resize(aux.color.size());
+    luminance.resize(aux.width * aux.height);
+
+    // one entry past the end for the interpolation at cosine 1
+    if(normal_weight.size() != NORMAL_STEPS + 2 || table_sigma != sigma_normal){
+        normal_weight.resize(NORMAL_STEPS + 2);
+        for(size_t k = 0; k < normal_weight.size(); k++){
+            normal_weight[k] = pow(min(1., double(k) / NORMAL_STEPS), double(sigma_normal));
+        }
+        table_sigma = sigma_normal;
+    }
+
+    // rows per job, enough jobs to balance the threads
+    size_t rows = max<size_t>(1, aux.height / (4 * pool.size()));
+    size_t njobs = (aux.height + rows - 1) / rows;
+
+    float* in = aux.color.data();
+    float* out = scratch.data();
+
+    for(size_t it = 0; it < iterations; it++){
+        size_t step = size_t(1) << it;
+        auto lum_job = [&](size_t i, size_t){
+            for(size_t p = i * rows * aux.width; p < min(aux.height, (i + 1) * rows) * aux.width; p++){
+                luminance[p] = 0.2126f * in[3 * p] + 0.7152f * in[3 * p + 1] + 0.0722f * in[3 * p + 2];
+            }
+        };
+        pool.parallel_for(njobs, lum_job);
+
+        auto job = [&](size_t i, size_t){
+            pass(aux, in, out, step, i * rows, min(aux.height, (i + 1) * rows));
+        };
+        pool.parallel_for(njobs, job);
+        swap(in, out);
+    }
+
+    // the result is in the buffer written last
+    if(in != aux.color.data()){
+        copy(scratch.begin(), scratch.end(), aux.color.begin());
+    }
+}
@@ -0,0 +1,380 @@
+#include "Encoder.h"
+
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+using namespace std;
+using namespace enc;
+
+/*******************************************************************************
+helpers
+*******************************************************************************/
+
+static void put_be32(uint8_t* s, uint32_t v){
+    s[0] = (v >> 24) & 0xFF;
+    s[1] = (v >> 16) & 0xFF;
+    s[2] = (v >>  8) & 0xFF;
+    s[3] =  v        & 0xFF;
+}
+
+static void put_le16(uint8_t* s, uint16_t v){
+    s[0] =  v       & 0xFF;
+    s[1] = (v >> 8) & 0xFF;
+}
+
+uint32_t enc::crc32(const uint8_t* data, size_t len, uint32_t crc){
+    // table for the reflected polynomial 0xEDB88320, built on first use
+    static const vector<uint32_t> table = [](){
+        vector<uint32_t> t(256);
+        for(uint32_t n = 0; n < 256; n++){
+            uint32_t c = n;
+            for(int k = 0; k < 8; k++){
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+
+    crc = ~crc;
+    for(size_t i = 0; i < len; i++){
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t enc::adler32(const uint8_t* data, size_t len, uint32_t adler){
+    constexpr uint32_t base = 65521;
+    // largest n such that 255n(n+1)/2 + (n+1)(base-1) fits in 32 bit
+    constexpr size_t nmax = 5552;
+
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+
+    while(len > 0){
+        size_t n = min(len, nmax);
+        len -= n;
+        while(n--){
+            a += *data++;
+            b += a;
+        }
+        a %= base;
+        b %= base;
+    }
+    return (b << 16) | a;
+}
+
+/*******************************************************************************
+Encoder base class
+*******************************************************************************/
+
+void Encoder::pack_rows(const bmp::Image& img, uint8_t* dst, size_t offset, size_t stride, bool bgr, bool bottom_up) const{
+    size_t width = img.width();
+    size_t height = img.height();
+
+    size_t ir = bgr ? 2 : 0;
+    size_t ib = bgr ? 0 : 2;
+
+    auto strip = [&](size_t row_begin, size_t row_end){
+        for(size_t k = row_begin; k < row_end; k++){
+            size_t y = bottom_up ? height - 1 - k : k;
+            uint8_t* s = dst + offset + k * stride;
+            for(size_t x = 0; x < width; x++){
+                bmp::Color c = img.pixelArray.get(x, y);
+                s[ir] = c[0];
+                s[1]  = c[1];
+                s[ib] = c[2];
+                s += 3;
+            }
+        }
+    };
+
+    size_t nstrips = workers ? min(workers->size(), height) : 1;
+    if(nstrips <= 1){
+        strip(0, height);
+        return;
+    }
+
+    size_t rows_per_strip = (height + nstrips - 1) / nstrips;
+    auto job = [&](size_t k, size_t){
+        strip(k * rows_per_strip, min(height, (k + 1) * rows_per_strip));
+    };
+    workers->parallel_for((height + rows_per_strip - 1) / rows_per_strip, job);
+}
+
+Bytes Encoder::encode(const bmp::Image& img) const{
+    Bytes out;
+    encode(img, out);
+    return out;
+}
+
+void Encoder::write(const bmp::Image& img, string filename) const{
+    Bytes out;
+    encode(img, out);
+
+    ofstream file(filename, ios::binary);
+    if(file.is_open()){
+        file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    }
+    else{
+        throw ios_base::failure("Opening file to write went wrong");
+    }
+}
+
+future<void> Encoder::write_async(bmp::Image img, string filename) const{
+    return async(launch::async, [this, img = move(img), filename](){
+        write(img, filename);
+    });
+}
+
+/*******************************************************************************
+BMP
+*******************************************************************************/
+
+void BMPEncoder::encode(const bmp::Image& img, Bytes& out) const{
+    constexpr size_t size_file_header = 14;
+    constexpr size_t size_info_header = 40;
+
+    size_t width = img.width();
+    size_t height = img.height();
+
+    // rows are padded to multiples of 4 bytes
+    size_t rowSize = (24 * width + 31) / 32 * 4;
+    size_t size = size_file_header + size_info_header + rowSize * height;
+
+    bmp::FileHeader fh;
+    fh.bfType[0] = 'B';
+    fh.bfType[1] = 'M';
+    fh.bfSize = size;
+    fh.bfReserved1 = 0;
+    fh.bfReserved2 = 0;
+    fh.bfOffBits = size_file_header + size_info_header;
+
+    bmp::InfoHeader ih;
+    ih.biSize = size_info_header;
+    ih.biWidth = width;
+    ih.biHeight = height;
+    ih.biPlanes = 1;
+    ih.biBitCount = 24;
+    ih.biCompression = 0;
+    ih.biSizeImage = rowSize * height;
+    ih.biXPelsPerMeter = 0;
+    ih.biYPelsPerMeter = 0;
+    ih.biClrUsed = 0;
+    ih.biClrImportant = 0;
+
+    out.assign(size, 0);
+    fh.write(reinterpret_cast<char*>(out.data()));
+    ih.write(reinterpret_cast<char*>(out.data() + size_file_header));
+
+    pack_rows(img, out.data(), fh.bfOffBits, rowSize, true, true);
+}
+
+/*******************************************************************************
+PPM
+*******************************************************************************/
+
+void PPMEncoder::encode(const bmp::Image& img, Bytes& out) const{
+    size_t width = img.width();
+    size_t height = img.height();
+
+    string header = "P6\n" + numtostr(width) + " " + numtostr(height) + "\n255\n";
+
+    out.resize(header.size() + 3 * width * height);
+    memcpy(out.data(), header.data(), header.size());
+
+    pack_rows(img, out.data(), header.size(), 3 * width, false, false);
+}
+
+/*******************************************************************************
+QOI
+    https://qoiformat.org/qoi-specification.pdf
+*******************************************************************************/
+
+void QOIEncoder::encode(const bmp::Image& img, Bytes& out) const{
+    constexpr uint8_t op_index = 0x00;
+    constexpr uint8_t op_diff  = 0x40;
+    constexpr uint8_t op_luma  = 0x80;
+    constexpr uint8_t op_run   = 0xC0;
+    constexpr uint8_t op_rgb   = 0xFE;
+
+    size_t width = img.width();
+    size_t height = img.height();
+    size_t npixels = width * height;
+
+    // the pixel gathering is parallel, the stream itself is sequential
+    Bytes rgb(3 * npixels);
+    pack_rows(img, rgb.data(), 0, 3 * width, false, false);
+
+    // worst case: every pixel is an op_rgb
+    out.resize(14 + 4 * npixels + 8);
+    uint8_t* s = out.data();
+
+    memcpy(s, "qoif", 4);
+    put_be32(s + 4, width);
+    put_be32(s + 8, height);
+    s[12] = 3; // channels
+    s[13] = 0; // sRGB with linear alpha
+    s += 14;
+
+    // the index starts as (0, 0, 0, 0) in the decoder, the pixels all
+    // have alpha 255 so a slot only matches once it was written
+    uint8_t index[64][4] = {{0}};
+    uint8_t pr = 0, pg = 0, pb = 0;
+    size_t run = 0;
+
+    const uint8_t* px = rgb.data();
+    for(size_t i = 0; i < npixels; i++, px += 3){
+        uint8_t r = px[0], g = px[1], b = px[2];
+
+        if(r == pr && g == pg && b == pb){
+            run++;
+            if(run == 62 || i == npixels - 1){
+                *s++ = op_run | (run - 1);
+                run = 0;
+            }
+            continue;
+        }
+
+        if(run > 0){
+            *s++ = op_run | (run - 1);
+            run = 0;
+        }
+
+        size_t hash = (r * 3 + g * 5 + b * 7 + 255 * 11) % 64;
+
+        if(index[hash][0] == r && index[hash][1] == g && index[hash][2] == b && index[hash][3] == 255){
+            *s++ = op_index | hash;
+        }
+        else{
+            index[hash][0] = r;
+            index[hash][1] = g;
+            index[hash][2] = b;
+            index[hash][3] = 255;
+
+            int8_t dr = r - pr;
+            int8_t dg = g - pg;
+            int8_t db = b - pb;
+
+            int8_t dr_dg = dr - dg;
+            int8_t db_dg = db - dg;
+
+            if(dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2){
+                *s++ = op_diff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2);
+            }
+            else if(dr_dg > -9 && dr_dg < 8 && dg > -33 && dg < 32 && db_dg > -9 && db_dg < 8){
+                *s++ = op_luma | (dg + 32);
+                *s++ = (dr_dg + 8) << 4 | (db_dg + 8);
+            }
+            else{
+                *s++ = op_rgb;
+                *s++ = r;
+                *s++ = g;
+                *s++ = b;
+            }
+        }
+
+        pr = r; pg = g; pb = b;
+    }
+
+    // end marker
+    for(int i = 0; i < 7; i++){
+        *s++ = 0;
+    }
+    *s++ = 1;
+
+    out.resize(s - out.data());
+}
+
+/*******************************************************************************
+PNG
+*******************************************************************************/
+
+void PNGEncoder::encode(const bmp::Image& img, Bytes& out) const{
+    constexpr size_t max_block = 65535;
+
+    size_t width = img.width();
+    size_t height = img.height();
+
+    // scanlines: filter byte (0 = none) followed by the RGB triplets
+    size_t stride = 1 + 3 * width;
+    size_t raw_size = stride * height;
+
+    Bytes raw(raw_size, 0);
+    pack_rows(img, raw.data(), 1, stride, false, false);
+
+    size_t nblocks = max((size_t) 1, (raw_size + max_block - 1) / max_block);
+    size_t zlib_size = 2 + 5 * nblocks + raw_size + 4;
+
+    size_t size = 8 + (12 + 13) + (12 + zlib_size) + 12;
+    out.resize(size);
+    uint8_t* s = out.data();
+
+    const uint8_t signature[8] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+    memcpy(s, signature, 8);
+    s += 8;
+
+    // IHDR
+    put_be32(s, 13);
+    memcpy(s + 4, "IHDR", 4);
+    put_be32(s + 8, width);
+    put_be32(s + 12, height);
+    s[16] = 8;  // bit depth
+    s[17] = 2;  // color type: RGB
+    s[18] = 0;  // compression
+    s[19] = 0;  // filter
+    s[20] = 0;  // interlace
+    put_be32(s + 21, crc32(s + 4, 17));
+    s += 25;
+
+    // IDAT: a zlib stream made of stored deflate blocks
+    uint8_t* chunk = s;
+    put_be32(s, zlib_size);
+    memcpy(s + 4, "IDAT", 4);
+    s += 8;
+
+    *s++ = 0x78;
+    *s++ = 0x01;
+
+    size_t pos = 0;
+    for(size_t i = 0; i < nblocks; i++){
+        uint16_t len = min(max_block, raw_size - pos);
+        *s++ = (i == nblocks - 1) ? 1 : 0; // BFINAL, BTYPE = 00
+        put_le16(s, len);
+        put_le16(s + 2, ~len);
+        s += 4;
+        memcpy(s, raw.data() + pos, len);
+        s += len;
+        pos += len;
+    }
+
+    put_be32(s, adler32(raw.data(), raw_size));
+    s += 4;
+
+    put_be32(s, crc32(chunk + 4, 4 + zlib_size));
+    s += 4;
+
+    // IEND
+    put_be32(s, 0);
+    memcpy(s + 4, "IEND", 4);
+    put_be32(s + 8, crc32(s + 4, 4));
+}
+
+/*******************************************************************************
+factory
+*******************************************************************************/
+
+unique_ptr<Encoder> enc::from_filename(string filename, ThreadPool* pool){
+    string ext;
+    size_t dot = filename.find_last_of('.');
+    if(dot != string::npos){
+        ext = filename.substr(dot + 1);
+        transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    }
+
+    if(ext == "ppm") return unique_ptr<Encoder>(new PPMEncoder(pool));
+    if(ext == "qoi") return unique_ptr<Encoder>(new QOIEncoder(pool));
+    if(ext == "png") return unique_ptr<Encoder>(new PNGEncoder(pool));
+    return unique_ptr<Encoder>(new BMPEncoder(pool));
+}
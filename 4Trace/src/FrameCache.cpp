@@ -0,0 +1,235 @@
+#include "FrameCache.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <ios>
+#include <algorithm>
+
+#include "Encoder.h"
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+
+FrameCache::FrameCache(const string& directory, size_t max_bytes) :
+    directory(directory),
+    max_bytes(max_bytes),
+    clock(0),
+    lines(0)
+{
+#ifdef _WIN32
+    _mkdir(directory.c_str());
+#else
+    mkdir(directory.c_str(), 0755);
+#endif
+    load_index();
+}
+
+FrameCache::~FrameCache(){
+    try{
+        save_index();
+    }
+    catch(...){
+        // nothing to do about it in a d'tor, the next run rebuilds less
+    }
+}
+
+string FrameCache::path(uint64_t key) const{
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    return directory + "/" + name + ".ppm";
+}
+
+void FrameCache::load_index(){
+    ifstream index(directory + "/index");
+    string line;
+    while(getline(index, line)){
+        istringstream fields(line);
+        string key;
+        Entry entry;
+        // a damaged line is skipped, its frame is rendered again
+        if(!(fields >> key >> entry.bytes >> entry.last_use) ||
+           key.size() != 16 || key.find_first_not_of("0123456789abcdef") != string::npos){
+            continue;
+        }
+        entries[stoull(key, nullptr, 16)] = entry;
+        lines++;
+    }
+
+    for(auto it = entries.begin(); it != entries.end(); ){
+        // frames deleted by hand or evicted since the last rewrite
+        if(!ifstream(path(it->first)).good()){
+            it = entries.erase(it);
+            continue;
+        }
+        clock = max(clock, it->second.last_use + 1);
+        counters.bytes += it->second.bytes;
+        ++it;
+    }
+    counters.frames = entries.size();
+
+    vector<pair<uint64_t, uint64_t>> uses;
+    for(const auto& e : entries){
+        uses.push_back(make_pair(e.second.last_use, e.first));
+    }
+    sort(uses.rbegin(), uses.rend());
+    for(const auto& u : uses){
+        lru.push_back(u.second);
+        entries[u.second].use = prev(lru.end());
+    }
+}
+
+void FrameCache::save_index(){
+    string tmp = directory + "/index.tmp";
+    {
+        ofstream index(tmp);
+        if(!index){
+            throw ios_base::failure("FrameCache: writing the index went wrong");
+        }
+        for(const auto& e : entries){
+            char key[17];
+            snprintf(key, sizeof(key), "%016llx", (unsigned long long)e.first);
+            index << key << " " << e.second.bytes << " " << e.second.last_use << "\n";
+        }
+    }
+    // a crash never leaves half an index
+    string final_name = directory + "/index";
+    std::remove(final_name.c_str());
+    std::rename(tmp.c_str(), final_name.c_str());
+    lines = entries.size();
+}
+
+void FrameCache::append_index(uint64_t key, const Entry& entry){
+    if(lines > 2 * entries.size() + 64){
+        save_index();
+        return;
+    }
+
+    // a torn last line is skipped by load_index()
+    ofstream index(directory + "/index", ios::app);
+    char name[17];
+    snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    index << name << " " << entry.bytes << " " << entry.last_use << "\n";
+    if(!index){
+        throw ios_base::failure("FrameCache: writing the index went wrong");
+    }
+    lines++;
+}
+
+void FrameCache::evict(){
+    while(counters.bytes > max_bytes && !entries.empty()){
+        auto oldest = entries.find(lru.back());
+        std::remove(path(oldest->first).c_str());
+        counters.bytes -= oldest->second.bytes;
+        counters.evictions++;
+        lru.pop_back();
+        entries.erase(oldest);
+    }
+    counters.frames = entries.size();
+}
+
+bool FrameCache::get(uint64_t key, bmp::Image& img){
+    lock_guard<mutex> lock(m);
+
+    auto it = entries.find(key);
+    if(it == entries.end()){
+        counters.misses++;
+        return false;
+    }
+
+    // binary ppm as written by put()
+    ifstream file(path(key), ios::binary);
+    string magic;
+    size_t width = 0, height = 0, maxval = 0;
+    file >> magic >> width >> height >> maxval;
+    file.get();
+
+    vector<char> rgb(3 * width * height);
+    if(!file || magic != "P6" || maxval != 255 || !file.read(rgb.data(), rgb.size())){
+        // unreadable, it's rendered again
+        counters.bytes -= it->second.bytes;
+        lru.erase(it->second.use);
+        entries.erase(it);
+        counters.frames = entries.size();
+        counters.misses++;
+        return false;
+    }
+
+    if(size_t(img.width()) != width || size_t(img.height()) != height){
+        img = bmp::Image(width, height);
+    }
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(rgb.data());
+    for(size_t y = 0; y < height; y++){
+        for(size_t x = 0; x < width; x++, p += 3){
+            img.pixelArray.set(x, y, bmp::Color(p[0], p[1], p[2]));
+        }
+    }
+
+    it->second.last_use = clock++;
+    lru.splice(lru.begin(), lru, it->second.use);
+    counters.hits++;
+    return true;
+}
+
+void FrameCache::put(uint64_t key, const bmp::Image& img){
+    enc::Bytes bytes = enc::PPMEncoder().encode(img);
+
+    lock_guard<mutex> lock(m);
+
+    string name = path(key);
+    FILE* file = fopen(name.c_str(), "wb");
+    if(!file){
+        throw ios_base::failure("FrameCache: writing " + name + " went wrong");
+    }
+    bool written = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    written = fclose(file) == 0 && written;
+    if(!written){
+        std::remove(name.c_str());
+        throw ios_base::failure("FrameCache: writing " + name + " went wrong");
+    }
+
+    auto it = entries.find(key);
+    if(it != entries.end()){
+        counters.bytes -= it->second.bytes;
+        lru.erase(it->second.use);
+    }
+    lru.push_front(key);
+    entries[key] = Entry{bytes.size(), clock++, lru.begin()};
+    counters.bytes += bytes.size();
+
+    evict();
+    if(entries.count(key)){
+        append_index(key, entries[key]);
+    }
+}
+
+void FrameCache::clear(){
+    lock_guard<mutex> lock(m);
+    for(const auto& e : entries){
+        std::remove(path(e.first).c_str());
+    }
+    entries.clear();
+    lru.clear();
+    counters.bytes = 0;
+    counters.frames = 0;
+    save_index();
+}
+
+void FrameCache::limit(size_t bytes){
+    lock_guard<mutex> lock(m);
+    max_bytes = bytes;
+    evict();
+    save_index();
+}
+
+FrameCache::Stats FrameCache::stats() const{
+    lock_guard<mutex> lock(m);
+    return counters;
+}
@@ -1,95 +1,133 @@
 #include "Glyphs.h"
+#include "glyph_font.h"
 
 #include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <ios>
 
 using namespace std;
 
 
-Glyphs::Glyphs(){
-    base = bmp::Image("./bmp_font/bmp_if_font_5.bmp");
+// the rows of the glyphs of a font bmp, dimx x dimy glyphs on a cols x
+// rows grid, a pixel is set if it is light
+static vector<uint32_t> pack_font(const string& font_path, size_t dimx, size_t dimy, size_t cols, size_t rows){
+    bmp::Image base(font_path);
+    if(size_t(base.width()) < dimx * cols || size_t(base.height()) < dimy * rows){
+        throw ios_base::failure("Glyphs: " + font_path + " is too small for the font");
+    }
 
+    vector<uint32_t> packed(rows * cols * dimy, 0);
     for(size_t irow = 0; irow < rows; irow++){
         for(size_t icol = 0; icol < cols; icol++){
-            bmp::Image glyph;
-            glyph = cut_glyph(icol, irow);
-
-            images.push_back(glyph);
+            uint32_t* glyph = &packed[(irow * cols + icol) * dimy];
+            for(size_t j = 0; j < dimy; j++){
+                for(size_t i = 0; i < dimx; i++){
+                    bmp::Color px = base.pixelArray.get(i + dimx * icol, j + dimy * irow);
+                    if(int(px.r()) + int(px.g()) + int(px.b()) > 3 * 127){
+                        glyph[j] |= uint32_t(1) << i;
+                    }
+                }
+            }
         }
     }
+    return packed;
 }
 
-bmp::Image Glyphs::cut_glyph(size_t icol, size_t irow){
+Glyphs::Glyphs() : font(&GLYPH_FONT[0][0]) {}
 
-    bmp::Image glyph(dimx, dimy);
+Glyphs::Glyphs(const string& font_path) :
+    loaded(pack_font(font_path, dimx, dimy, cols, rows))
+{
+    font = loaded.data();
+}
 
-    for(size_t i = 0; i < dimx; i++){
-        for(size_t j = 0; j < dimy; j++){
+void Glyphs::write_header(const string& font_path, const string& header_path){
+    Glyphs glyphs(font_path);
 
-            bmp::Color px = base.pixelArray.get(i + dimx * icol, j + dimy * irow);
+    ofstream out(header_path);
+    if(!out){
+        throw ios_base::failure("Glyphs: opening " + header_path + " went wrong");
+    }
 
-            glyph.pixelArray.set(i, j, px);
+    out << "#ifndef GLYPH_FONT_H\n"
+           "#define GLYPH_FONT_H\n"
+           "\n"
+           "#include <cstdint>\n"
+           "\n"
+           "// generated from " << font_path << " by Glyphs::write_header(),\n"
+           "// 128 glyphs of 32 rows, bit i of a row is column i\n"
+           "constexpr uint32_t GLYPH_FONT[128][32] = {\n";
+
+    out << hex << setfill('0');
+    size_t nglyphs = glyphs.rows * glyphs.cols;
+    for(size_t g = 0; g < nglyphs; g++){
+        out << "    {";
+        for(size_t j = 0; j < glyphs.dimy; j++){
+            out << (j == 0 ? "\n        " : j % 8 == 0 ? ",\n        " : ", ");
+            out << "0x" << setw(8) << glyphs.font[g * glyphs.dimy + j];
         }
+        out << "\n    }" << (g + 1 < nglyphs ? "," : "") << "\n";
     }
+    out << "};\n"
+           "\n"
+           "#endif // GLYPH_FONT_H\n";
 
-    return glyph;
+    if(!out){
+        throw ios_base::failure("Glyphs: writing " + header_path + " went wrong");
+    }
 }
 
-bmp::Image Glyphs::get_char(char c){
+size_t Glyphs::glyph_index(char c) const{
     size_t pos = (int) c;
     if(pos < 96){pos -= 1;}
-    return images[pos];
+    return pos;
 }
 
-void Glyphs::imprint(bmp::Image& imp_image, char c, V2<size_t> position, double scale){
-
-    bmp::Image character = get_char(c);
-    bmp::Image scaled;
-
-    size_t dimx_char = int(double(dimx) * scale);
-    size_t dimy_char = int(double(dimy) * scale);
-
-    if(scale != 1){
+bmp::Image Glyphs::get_char(char c){
+    size_t glyph = glyph_index(c);
+    bmp::Image character(dimx, dimy);
 
+    for(size_t i = 0; i < dimx; i++){
+        for(size_t j = 0; j < dimy; j++){
+            character.pixelArray.set(i, j, bmp::Color(pixel(glyph, i, j) ? 255 : 0));
+        }
+    }
+    return character;
+}
 
-        // scale
-        scaled = bmp::Image(dimx_char, dimy_char);
+void Glyphs::imprint(bmp::Image& imp_image, char c, V2<size_t> position, double scale, size_t row0){
 
-        for(size_t i = 0; i < dimx_char; i++){
-            for(size_t j = 0; j < dimy_char; j++){
-                size_t src_x = double(i) / double(dimx_char) * dimx;
-                size_t src_y = double(j) / double(dimy_char) * dimy;
+    size_t glyph = glyph_index(c);
 
-                src_x = min( (size_t) dimx - 1, src_x);
-                src_y = min( (size_t) dimy - 1, src_y);
+    size_t dimx_char = int(double(dimx) * scale);
+    size_t dimy_char = int(double(dimy) * scale);
 
-                bmp::Color px = character.pixelArray.get(src_x, src_y);
-                scaled.pixelArray.set(i, j, px);
-            }
-        }
+    // nearest glyph pixel of every column and row
+    vector<size_t> src_x(dimx_char), src_y(dimy_char);
+    for(size_t i = 0; i < dimx_char; i++){
+        src_x[i] = min( (size_t) dimx - 1, size_t(double(i) / double(dimx_char) * dimx));
     }
-    else{
-        scaled = character;
+    for(size_t j = 0; j < dimy_char; j++){
+        src_y[j] = min( (size_t) dimy - 1, size_t(double(j) / double(dimy_char) * dimy));
     }
 
-
-
     for(size_t i = 0; i < dimx_char; i++){
         for(size_t j = 0; j < dimy_char; j++){
-            bmp::Color px = scaled.pixelArray.get(i, j);
             size_t xpos = i + position.x();
             size_t ypos = j + position.y();
 
             bool check_border_x = (xpos < (size_t) imp_image.width() );
-            bool check_border_y = (ypos < (size_t) imp_image.height());
+            bool check_border_y = (ypos >= row0 && ypos - row0 < (size_t) imp_image.height());
 
             if(check_border_x && check_border_y ){
-                imp_image.pixelArray.set(xpos, ypos, px);
+                imp_image.pixelArray.set(xpos, ypos - row0, bmp::Color(pixel(glyph, src_x[i], src_y[j]) ? 255 : 0));
             }
         }
     }
 }
 
-void Glyphs::imprint(bmp::Image& imp_image, string str, V2<size_t> position, double scale){
+void Glyphs::imprint(bmp::Image& imp_image, string str, V2<size_t> position, double scale, size_t row0){
 
     size_t dimx_char = int(double(dimx) * scale);
 
@@ -98,6 +136,6 @@ void Glyphs::imprint(bmp::Image& imp_image, string str, V2<size_t> position, dou
     for(size_t i = 0; i < str.size(); i++){
         V2<size_t> char_pos = position;
         char_pos.x() = position.x() + i * dimx_char;
-        imprint(imp_image, str[i], char_pos, scale);
+        imprint(imp_image, str[i], char_pos, scale, row0);
     }
 }
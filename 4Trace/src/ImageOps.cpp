@@ -0,0 +1,438 @@
+#include "ImageOps.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define IMAGEOPS_SSE2
+#endif
+
+using namespace std;
+using namespace imgops;
+
+static_assert(sizeof(bmp::Color) == 3, "ImageOps: the pixels must be packed rgb bytes");
+
+
+static uint8_t* bytes(bmp::Image& img){
+    return reinterpret_cast<uint8_t*>(img.pixelArray.data());
+}
+
+static const uint8_t* bytes(const bmp::Image& img){
+    return reinterpret_cast<const uint8_t*>(img.pixelArray.data());
+}
+
+// f(x0, x1) on the columns [0, n) in jobs of a few columns
+template<typename F>
+static void for_columns(size_t n, ThreadPool* pool, const F& f){
+    const size_t chunk = 16;
+    size_t njobs = (n + chunk - 1) / chunk;
+    auto job = [&](size_t k, size_t){
+        f(k * chunk, min(n, (k + 1) * chunk));
+    };
+    if(pool && pool->size() > 1 && njobs > 1){
+        pool->parallel_for(njobs, job);
+    }
+    else{
+        for(size_t k = 0; k < njobs; k++){
+            job(k, 0);
+        }
+    }
+}
+
+/*******************************************************************************
+kernels
+    the loops over the bytes of a column, 16 bytes at a time with SSE2
+    where it's available, the scalar loop does the rest
+*******************************************************************************/
+
+// out[k] = a[k] * wa + b[k] * wb, wa + wb <= 256
+static void weigh(const uint8_t* a, const uint8_t* b, uint16_t wa, uint16_t wb, uint16_t* out, size_t n){
+    size_t k = 0;
+#ifdef IMAGEOPS_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i va = _mm_set1_epi16(wa), vb = _mm_set1_epi16(wb);
+    for(; k + 16 <= n; k += 16){
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + k));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), va), _mm_mullo_epi16(_mm_unpacklo_epi8(y, zero), vb));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), va), _mm_mullo_epi16(_mm_unpackhi_epi8(y, zero), vb));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k + 8), hi);
+    }
+#endif
+    for(; k < n; k++){
+        out[k] = a[k] * wa + b[k] * wb;
+    }
+}
+
+// out[k] = (a[k] * wa + b[k] * wb) / 256 rounded, wa + wb = 256
+static void lerp(const uint8_t* a, const uint8_t* b, uint16_t wa, uint16_t wb, uint8_t* out, size_t n){
+    size_t k = 0;
+#ifdef IMAGEOPS_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i half = _mm_set1_epi16(128);
+    __m128i va = _mm_set1_epi16(wa), vb = _mm_set1_epi16(wb);
+    for(; k + 16 <= n; k += 16){
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + k));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(x, zero), va), _mm_mullo_epi16(_mm_unpacklo_epi8(y, zero), vb));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(x, zero), va), _mm_mullo_epi16(_mm_unpackhi_epi8(y, zero), vb));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, half), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, half), 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for(; k < n; k++){
+        out[k] = (a[k] * wa + b[k] * wb + 128) >> 8;
+    }
+}
+
+// sum[k] += a[k]
+static void accumulate(const uint8_t* a, uint32_t* sum, size_t n){
+    size_t k = 0;
+#ifdef IMAGEOPS_SSE2
+    __m128i zero = _mm_setzero_si128();
+    for(; k + 16 <= n; k += 16){
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + k));
+        __m128i lo = _mm_unpacklo_epi8(x, zero);
+        __m128i hi = _mm_unpackhi_epi8(x, zero);
+        __m128i parts[4] = {_mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                            _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero)};
+        for(size_t q = 0; q < 4; q++){
+            __m128i* s = reinterpret_cast<__m128i*>(sum + k + 4 * q);
+            _mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s), parts[q]));
+        }
+    }
+#endif
+    for(; k < n; k++){
+        sum[k] += a[k];
+    }
+}
+
+// t / 255 rounded, for t up to 255 * 255
+static inline uint16_t div255(uint16_t t){
+    t += 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+#ifdef IMAGEOPS_SSE2
+static inline __m128i div255(__m128i t){
+    t = _mm_add_epi16(t, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// (in * a + out * (255 - a)) / 255 on 8 lanes of 16 bits
+static inline __m128i mix8(__m128i in, __m128i out, __m128i a){
+    __m128i b = _mm_sub_epi16(_mm_set1_epi16(255), a);
+    return div255(_mm_add_epi16(_mm_mullo_epi16(in, a), _mm_mullo_epi16(out, b)));
+}
+#endif
+
+// out[k] = in[k] over out[k] with the opacity alpha[k], or the constant
+// opacity a if alpha is nullptr
+static void mix(const uint8_t* in, const uint8_t* alpha, uint8_t a, uint8_t* out, size_t n){
+    size_t k = 0;
+#ifdef IMAGEOPS_SSE2
+    __m128i zero = _mm_setzero_si128();
+    __m128i va = _mm_set1_epi16(a);
+    for(; k + 16 <= n; k += 16){
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + k));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(out + k));
+        __m128i a_lo = va, a_hi = va;
+        if(alpha){
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(alpha + k));
+            a_lo = _mm_unpacklo_epi8(w, zero);
+            a_hi = _mm_unpackhi_epi8(w, zero);
+        }
+        __m128i lo = mix8(_mm_unpacklo_epi8(x, zero), _mm_unpacklo_epi8(y, zero), a_lo);
+        __m128i hi = mix8(_mm_unpackhi_epi8(x, zero), _mm_unpackhi_epi8(y, zero), a_hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), _mm_packus_epi16(lo, hi));
+    }
+#endif
+    for(; k < n; k++){
+        uint16_t w = alpha ? alpha[k] : a;
+        out[k] = div255(in[k] * w + out[k] * (255 - w));
+    }
+}
+
+/*******************************************************************************
+resampling
+    separable: the source columns a destination column needs are combined
+    into a scratch column first, contiguous bytes in, wider integers out,
+    then every destination pixel of the column is taken from its rows
+*******************************************************************************/
+
+// destination d interpolates i0 and i1, i1 weighs w1 / 256
+struct Tap{
+    size_t i0, i1;
+    uint32_t w1;
+};
+
+static vector<Tap> bilinear_taps(size_t n_src, size_t n_dst){
+    vector<Tap> taps(n_dst);
+    double scale = double(n_src) / n_dst;
+    for(size_t d = 0; d < n_dst; d++){
+        double s = max(0., (d + 0.5) * scale - 0.5);
+        size_t i0 = min(size_t(s), n_src - 1);
+        taps[d].i0 = i0;
+        taps[d].i1 = min(i0 + 1, n_src - 1);
+        taps[d].w1 = uint32_t(lround(min(1., s - i0) * 256));
+    }
+    return taps;
+}
+
+// destination d averages the sources [first, second)
+static vector<pair<size_t, size_t>> box_ranges(size_t n_src, size_t n_dst){
+    vector<pair<size_t, size_t>> ranges(n_dst);
+    for(size_t d = 0; d < n_dst; d++){
+        size_t a = d * n_src / n_dst;
+        size_t b = max(a + 1, (d + 1) * n_src / n_dst);
+        ranges[d] = make_pair(a, min(b, n_src));
+    }
+    return ranges;
+}
+
+// the columns are interpolated first, each destination column mixes two
+// source columns and then takes its rows from the mix
+static void resize_bilinear(const bmp::Image& src, bmp::Image& dst, ThreadPool* pool){
+    size_t sw = src.width(), sh = src.height();
+    size_t dw = dst.width(), dh = dst.height();
+    vector<Tap> tx = bilinear_taps(sw, dw);
+    vector<Tap> ty = bilinear_taps(sh, dh);
+
+    const uint8_t* s = bytes(src);
+    uint8_t* d = bytes(dst);
+
+    for_columns(dw, pool, [&](size_t x0, size_t x1){
+        vector<uint16_t> column(3 * sh);
+        for(size_t x = x0; x < x1; x++){
+            const uint8_t* a = s + 3 * sh * tx[x].i0;
+            const uint8_t* b = s + 3 * sh * tx[x].i1;
+            uint16_t wb = tx[x].w1, wa = 256 - wb;
+            weigh(a, b, wa, wb, column.data(), 3 * sh);
+
+            uint8_t* out = d + 3 * dh * x;
+            for(size_t y = 0; y < dh; y++){
+                const uint16_t* p0 = &column[3 * ty[y].i0];
+                const uint16_t* p1 = &column[3 * ty[y].i1];
+                uint32_t w1 = ty[y].w1, w0 = 256 - w1;
+                for(size_t c = 0; c < 3; c++){
+                    out[3 * y + c] = (p0[c] * w0 + p1[c] * w1 + 32768) >> 16;
+                }
+            }
+        }
+    });
+}
+
+// for a wider destination the rows of the source columns are resampled
+// first, at 8 bits, so the per pixel work is on the fewer source columns
+// and the destination columns are plain vector mixes
+static void resize_bilinear_wide(const bmp::Image& src, bmp::Image& dst, ThreadPool* pool){
+    size_t sw = src.width(), sh = src.height();
+    size_t dw = dst.width(), dh = dst.height();
+    vector<Tap> tx = bilinear_taps(sw, dw);
+    vector<Tap> ty = bilinear_taps(sh, dh);
+
+    const uint8_t* s = bytes(src);
+    uint8_t* d = bytes(dst);
+    vector<uint8_t> rows(3 * sw * dh);
+
+    for_columns(sw, pool, [&](size_t x0, size_t x1){
+        for(size_t x = x0; x < x1; x++){
+            const uint8_t* in = s + 3 * sh * x;
+            uint8_t* out = &rows[3 * dh * x];
+            for(size_t y = 0; y < dh; y++){
+                const uint8_t* p0 = in + 3 * ty[y].i0;
+                const uint8_t* p1 = in + 3 * ty[y].i1;
+                uint32_t w1 = ty[y].w1, w0 = 256 - w1;
+                for(size_t c = 0; c < 3; c++){
+                    out[3 * y + c] = (p0[c] * w0 + p1[c] * w1 + 128) >> 8;
+                }
+            }
+        }
+    });
+
+    for_columns(dw, pool, [&](size_t x0, size_t x1){
+        for(size_t x = x0; x < x1; x++){
+            uint16_t wb = tx[x].w1, wa = 256 - wb;
+            lerp(&rows[3 * dh * tx[x].i0], &rows[3 * dh * tx[x].i1], wa, wb, d + 3 * dh * x, 3 * dh);
+        }
+    });
+}
+
+static void resize_box(const bmp::Image& src, bmp::Image& dst, ThreadPool* pool){
+    size_t sw = src.width(), sh = src.height();
+    size_t dw = dst.width(), dh = dst.height();
+    vector<pair<size_t, size_t>> rx = box_ranges(sw, dw);
+    vector<pair<size_t, size_t>> ry = box_ranges(sh, dh);
+
+    const uint8_t* s = bytes(src);
+    uint8_t* d = bytes(dst);
+
+    for_columns(dw, pool, [&](size_t x0, size_t x1){
+        vector<uint32_t> column(3 * sh);
+        for(size_t x = x0; x < x1; x++){
+            fill(column.begin(), column.end(), 0);
+            for(size_t i = rx[x].first; i < rx[x].second; i++){
+                accumulate(s + 3 * sh * i, column.data(), 3 * sh);
+            }
+
+            uint8_t* out = d + 3 * dh * x;
+            uint64_t width = rx[x].second - rx[x].first;
+            for(size_t y = 0; y < dh; y++){
+                uint64_t count = width * (ry[y].second - ry[y].first);
+                uint64_t sum[3] = {0, 0, 0};
+                for(size_t j = ry[y].first; j < ry[y].second; j++){
+                    sum[0] += column[3 * j];
+                    sum[1] += column[3 * j + 1];
+                    sum[2] += column[3 * j + 2];
+                }
+                for(size_t c = 0; c < 3; c++){
+                    out[3 * y + c] = (sum[c] + count / 2) / count;
+                }
+            }
+        }
+    });
+}
+
+void imgops::resize(const bmp::Image& src, bmp::Image& dst, Filter filter, ThreadPool* pool){
+    if(src.width() <= 0 || src.height() <= 0 || dst.width() <= 0 || dst.height() <= 0){
+        throw "ImageOps: resize of an empty image";
+    }
+    if(src.width() == dst.width() && src.height() == dst.height()){
+        dst.pixelArray = src.pixelArray;
+        return;
+    }
+    if(filter == Filter::box){
+        resize_box(src, dst, pool);
+    }
+    else if(dst.width() > src.width()){
+        resize_bilinear_wide(src, dst, pool);
+    }
+    else{
+        resize_bilinear(src, dst, pool);
+    }
+}
+
+bmp::Image imgops::resize(const bmp::Image& src, size_t width, size_t height, Filter filter, ThreadPool* pool){
+    bmp::Image dst(width, height);
+    resize(src, dst, filter, pool);
+    return dst;
+}
+
+bmp::Image imgops::thumbnail(const bmp::Image& src, size_t width, size_t height, ThreadPool* pool){
+    double scale = min(double(width) / src.width(), double(height) / src.height());
+    size_t tw = max<long>(1, lround(src.width() * scale));
+    size_t th = max<long>(1, lround(src.height() * scale));
+    return resize(src, tw, th, Filter::box, pool);
+}
+
+vector<bmp::Image> imgops::mips(const bmp::Image& src, size_t levels, ThreadPool* pool){
+    vector<bmp::Image> chain;
+    if(levels == 0){
+        return chain;
+    }
+    chain.push_back(src);
+    while(chain.size() < levels && (chain.back().width() > 1 || chain.back().height() > 1)){
+        const bmp::Image& last = chain.back();
+        bmp::Image half(max(1, last.width() / 2), max(1, last.height() / 2));
+        resize(last, half, Filter::box, pool);
+        chain.push_back(half);
+    }
+    return chain;
+}
+
+/*******************************************************************************
+compositing
+*******************************************************************************/
+
+// overlap of src placed at (x, y) of dst, false if there's none
+struct Overlap{
+    size_t dx, dy, sx, sy, width, height;
+};
+
+static bool overlap(const bmp::Image& dst, const bmp::Image& src, int x, int y, Overlap& o){
+    long x0 = max<long>(0, x), x1 = min<long>(dst.width(), long(x) + src.width());
+    long y0 = max<long>(0, y), y1 = min<long>(dst.height(), long(y) + src.height());
+    if(x0 >= x1 || y0 >= y1){
+        return false;
+    }
+    o.dx = x0;
+    o.dy = y0;
+    o.sx = x0 - x;
+    o.sy = y0 - y;
+    o.width = x1 - x0;
+    o.height = y1 - y0;
+    return true;
+}
+
+bmp::Image imgops::crop(const bmp::Image& src, int x, int y, size_t width, size_t height){
+    long x0 = max<long>(0, x), x1 = min<long>(src.width(), long(x) + long(width));
+    long y0 = max<long>(0, y), y1 = min<long>(src.height(), long(y) + long(height));
+    if(x0 >= x1 || y0 >= y1){
+        throw "ImageOps: the crop is outside the image";
+    }
+    bmp::Image out(x1 - x0, y1 - y0);
+    blit(out, src, -x0, -y0);
+    return out;
+}
+
+void imgops::blit(bmp::Image& dst, const bmp::Image& src, int x, int y, ThreadPool* pool){
+    Overlap o;
+    if(!overlap(dst, src, x, y, o)){
+        return;
+    }
+    size_t dh = dst.height(), sh = src.height();
+    const uint8_t* s = bytes(src);
+    uint8_t* d = bytes(dst);
+
+    for_columns(o.width, pool, [&](size_t i0, size_t i1){
+        for(size_t i = i0; i < i1; i++){
+            memcpy(d + 3 * ((o.dx + i) * dh + o.dy), s + 3 * ((o.sx + i) * sh + o.sy), 3 * o.height);
+        }
+    });
+}
+
+void imgops::blend(bmp::Image& dst, const bmp::Image& src, uint8_t alpha, int x, int y, ThreadPool* pool){
+    Overlap o;
+    if(!overlap(dst, src, x, y, o)){
+        return;
+    }
+    size_t dh = dst.height(), sh = src.height();
+    const uint8_t* s = bytes(src);
+    uint8_t* d = bytes(dst);
+
+    for_columns(o.width, pool, [&](size_t i0, size_t i1){
+        for(size_t i = i0; i < i1; i++){
+            mix(s + 3 * ((o.sx + i) * sh + o.sy), nullptr, alpha, d + 3 * ((o.dx + i) * dh + o.dy), 3 * o.height);
+        }
+    });
+}
+
+void imgops::over(bmp::Image& dst, const bmp::Image& src, const vector<uint8_t>& alpha, int x, int y, ThreadPool* pool){
+    if(alpha.size() != size_t(src.width()) * src.height()){
+        throw "ImageOps: one alpha per pixel of the source is needed";
+    }
+    Overlap o;
+    if(!overlap(dst, src, x, y, o)){
+        return;
+    }
+    size_t dh = dst.height(), sh = src.height();
+    const uint8_t* s = bytes(src);
+    uint8_t* d = bytes(dst);
+
+    for_columns(o.width, pool, [&](size_t i0, size_t i1){
+        // the alpha of the column spread over the channels
+        vector<uint8_t> a(3 * o.height);
+        for(size_t i = i0; i < i1; i++){
+            const uint8_t* column = &alpha[(o.sx + i) * sh + o.sy];
+            for(size_t j = 0; j < o.height; j++){
+                a[3 * j] = a[3 * j + 1] = a[3 * j + 2] = column[j];
+            }
+
+            mix(s + 3 * ((o.sx + i) * sh + o.sy), a.data(), 0, d + 3 * ((o.dx + i) * dh + o.dy), 3 * o.height);
+        }
+    });
+}
@@ -0,0 +1,133 @@
+#include "PageCache.h"
+
+#include <ios>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define PAGECACHE_PREAD
+#endif
+
+using namespace std;
+
+
+PageCache::PageCache(const string& path, size_t page_bytes, size_t budget) :
+    file(path, ios::binary),
+    fd(-1),
+    page_bytes(page_bytes),
+    budget(budget)
+{
+    if(!file || page_bytes == 0){
+        throw ios_base::failure("PageCache: opening " + path + " went wrong");
+    }
+    file.seekg(0, ios::end);
+    file_size = file.tellg();
+#ifdef PAGECACHE_PREAD
+    fd = open(path.c_str(), O_RDONLY);
+    if(fd < 0){
+        throw ios_base::failure("PageCache: opening " + path + " went wrong");
+    }
+#endif
+}
+
+PageCache::~PageCache(){
+#ifdef PAGECACHE_PREAD
+    close(fd);
+#endif
+}
+
+// no cache lock, concurrent reads don't share a file position
+void PageCache::read_at(uint64_t offset, void* data, size_t size){
+#ifdef PAGECACHE_PREAD
+    char* p = static_cast<char*>(data);
+    while(size > 0){
+        ssize_t n = pread(fd, p, size, offset);
+        if(n <= 0){
+            throw ios_base::failure("PageCache: reading the file went wrong");
+        }
+        p += n;
+        offset += n;
+        size -= n;
+    }
+#else
+    lock_guard<mutex> lock(file_m);
+    file.seekg(offset);
+    file.read(static_cast<char*>(data), size);
+    if(!file){
+        file.clear();
+        throw ios_base::failure("PageCache: reading the file went wrong");
+    }
+#endif
+}
+
+void PageCache::read(uint64_t offset, void* data, size_t size){
+    if(offset + size > file_size){
+        throw ios_base::failure("PageCache: read past the end of the file");
+    }
+    read_at(offset, data, size);
+
+    lock_guard<mutex> lock(m);
+    counters.bytes_read += size;
+}
+
+// drops the least recently used pages until keep more bytes fit
+void PageCache::evict(size_t keep){
+    while(!lru.empty() && counters.resident + keep > budget){
+        auto entry = pages.find(lru.back());
+        counters.resident -= entry->second.page->size();
+        pages.erase(entry);
+        lru.pop_back();
+        counters.evictions++;
+    }
+}
+
+PageCache::Page PageCache::get(uint64_t p){
+    {
+        lock_guard<mutex> lock(m);
+        auto found = pages.find(p);
+        if(found != pages.end()){
+            lru.splice(lru.begin(), lru, found->second.use);
+            counters.hits++;
+            return found->second.page;
+        }
+    }
+
+    uint64_t offset = p * page_bytes;
+    if(offset >= file_size){
+        throw ios_base::failure("PageCache: page past the end of the file");
+    }
+    size_t size = min<uint64_t>(page_bytes, file_size - offset);
+
+    auto page = make_shared<vector<uint8_t>>(size);
+    read_at(offset, page->data(), size);
+
+    lock_guard<mutex> lock(m);
+    counters.faults++;
+    counters.bytes_read += size;
+
+    // another thread read the same page meanwhile, its copy is kept
+    auto found = pages.find(p);
+    if(found != pages.end()){
+        lru.splice(lru.begin(), lru, found->second.use);
+        return found->second.page;
+    }
+
+    evict(size);
+    lru.push_front(p);
+    pages[p] = Entry{page, lru.begin()};
+    counters.resident += size;
+    counters.peak_resident = max(counters.peak_resident, counters.resident);
+    return page;
+}
+
+void PageCache::limit(size_t bytes){
+    lock_guard<mutex> lock(m);
+    budget = bytes;
+    evict(0);
+}
+
+PageCache::Stats PageCache::stats() const{
+    lock_guard<mutex> lock(m);
+    return counters;
+}
@@ -0,0 +1,564 @@
+#include "RenderServer.h"
+
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+
+#include "Encoder.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define RENDERSERVER_SOCKETS
+#endif
+
+using namespace std;
+
+
+// next non empty line without comment, false at the end of the stream
+static bool next_line(istream& in, string& line){
+    while(getline(in, line)){
+        size_t hash = line.find('#');
+        if(hash != string::npos){
+            line.erase(hash);
+        }
+        if(line.find_first_not_of(" \t\r") != string::npos){
+            return true;
+        }
+    }
+    return false;
+}
+
+// after an error in a block its remaining lines are dropped
+static void skip_block(istream& in){
+    string line, key;
+    while(next_line(in, line)){
+        istringstream(line) >> key;
+        if(key == "end"){
+            return;
+        }
+    }
+}
+
+template<typename T>
+static T read(istringstream& args, const string& what){
+    T value;
+    if(!(args >> value)){
+        throw "RenderServer: expected " + what;
+    }
+    return value;
+}
+
+template<size_t dim>
+static Vector<double, dim> read_vector(istringstream& args, const string& what){
+    Vector<double, dim> v;
+    for(size_t k = 0; k < dim; k++){
+        v[k] = read<double>(args, what);
+    }
+    return v;
+}
+
+static Color read_color(istringstream& args, const string& what){
+    double r = read<double>(args, what);
+    double g = read<double>(args, what);
+    double b = read<double>(args, what);
+    return Color(r, g, b);
+}
+
+// the lines of a scene block up to end
+template<size_t dim>
+static void read_objects(istream& in, Scene<dim>& scene){
+    string line;
+    while(next_line(in, line)){
+        istringstream args(line);
+        string kind;
+        args >> kind;
+        if(kind == "end"){
+            return;
+        }
+
+        if(kind != "sphere" && kind != "plane" && kind != "box"){
+            throw "RenderServer: unknown object " + kind;
+        }
+
+        Vector<double, dim> a = read_vector<dim>(args, kind + " position");
+        if(kind == "sphere"){
+            double radius = read<double>(args, "sphere radius");
+            Color surface = read_color(args, "surface color");
+            Color emission = read_color(args, "emission color");
+            double transparency = read<double>(args, "transparency");
+            double reflection = read<double>(args, "reflection");
+            scene.spheres.push_back(Sphere<dim>(a, radius, surface, emission, transparency, reflection));
+        }
+        else{
+            Vector<double, dim> b = read_vector<dim>(args, kind + " direction");
+            Color surface = read_color(args, "surface color");
+            Color emission = read_color(args, "emission color");
+            double transparency = read<double>(args, "transparency");
+            double reflection = read<double>(args, "reflection");
+            if(kind == "plane"){
+                scene.planes.push_back(Plane<dim>(a, b, surface, emission, transparency, reflection));
+            }
+            else{
+                scene.boxes.push_back(Box<dim>(a, b, surface, emission, transparency, reflection));
+            }
+        }
+    }
+    throw string("RenderServer: scene without end");
+}
+
+
+RenderServer::RenderServer(size_t nthreads) :
+    renderer3(Camera<3>(), max<size_t>(1, nthreads)),
+    renderer4(Camera<4>(), max<size_t>(1, nthreads)),
+    abort(false),
+    rendered(false),
+    next_order(0),
+    next_version(0),
+    pending(0),
+    stop(false)
+{
+    renderer3.abort_on(&abort);
+    renderer4.abort_on(&abort);
+    worker = thread(&RenderServer::work, this);
+}
+
+RenderServer::~RenderServer(){
+    {
+        lock_guard<mutex> lock(m);
+        stop = true;
+        abort = true;
+    }
+    cv.notify_all();
+    worker.join();
+}
+
+void RenderServer::reply(const Job& job, const string& line){
+    lock_guard<mutex> lock(*job.out_mutex);
+    *job.out << line << endl;
+}
+
+void RenderServer::work(){
+    unique_lock<mutex> lock(m);
+    while(true){
+        cv.wait(lock, [this]{ return stop || !queue.empty(); });
+        if(stop){
+            return;
+        }
+
+        // highest priority, then first queued
+        auto best = min_element(queue.begin(), queue.end(), [](const Job& a, const Job& b){
+            return a.priority != b.priority ? a.priority > b.priority : a.order < b.order;
+        });
+        Job job = *best;
+        queue.erase(best);
+
+        auto entry = scenes.find(job.scene);
+        if(entry == scenes.end()){
+            // the session waits for pending, it goes down after the reply
+            lock.unlock();
+            reply(job, "error unknown scene " + job.scene);
+            lock.lock();
+            pending--;
+            cv.notify_all();
+            continue;
+        }
+        running = job.name;
+        abort = false;
+        rendered = false;
+
+        // a scene replaced meanwhile is copied again
+        string version = job.scene + "#" + numtostr(entry->second.version);
+        size_t dim = entry->second.dim;
+        if(dim == 3 && loaded3 != version){
+            renderer3.scene() = entry->second.scene3;
+        }
+        if(dim == 4 && loaded4 != version){
+            renderer4.scene() = entry->second.scene4;
+        }
+        lock.unlock();
+
+        try{
+            if(dim == 3){
+                loaded3 = version;
+                render(job, renderer3);
+            }
+            else{
+                loaded4 = version;
+                render(job, renderer4);
+            }
+        }
+        catch(const exception& e){
+            reply(job, "error " + job.name + " " + e.what());
+        }
+        catch(const char* e){
+            reply(job, "error " + job.name + " " + e);
+        }
+        catch(const string& e){
+            reply(job, "error " + job.name + " " + e);
+        }
+
+        lock.lock();
+        running.clear();
+        pending--;
+        cv.notify_all();
+    }
+}
+
+template<size_t dim>
+void RenderServer::render(const Job& job, Renderer<dim>& renderer){
+    auto start = chrono::steady_clock::now();
+
+    Camera<dim> cam(job.width, job.height, job.fov);
+    if(!job.position.empty()){
+        if(job.position.size() != dim){
+            throw string("position doesn't match the scene");
+        }
+        for(size_t k = 0; k < dim; k++){
+            cam.position[k] = job.position[k];
+        }
+    }
+    for(const Turn& t : job.turns){
+        if(t.a >= dim || t.b >= dim){
+            throw string("turn out of the scene dimensions");
+        }
+        cam.turn(t.a, t.b, t.degrees);
+    }
+
+    renderer.camera() = cam;
+    renderer.engine(job.engine);
+    renderer.light_samples(job.light_samples);
+    renderer.area_lights(job.area_samples);
+    renderer.denoise(job.denoise);
+
+    bmp::Image& img = renderer.render();
+
+    // a cancel up to here drops the frame, a later one is answered as too late
+    bool cancelled;
+    {
+        lock_guard<mutex> lock(m);
+        rendered = true;
+        cancelled = abort;
+    }
+    if(cancelled){
+        reply(job, "cancelled " + job.name);
+        return;
+    }
+
+    if(!job.label.empty()){
+        if(!font){
+            font.reset(new Glyphs());
+        }
+        font->imprint(img, job.label, V2<size_t>(job.label_x, job.label_y), job.label_scale);
+    }
+
+    if(job.output[0] == '-'){
+        string ext = job.output.size() > 2 ? job.output.substr(2) : "bmp";
+        unique_ptr<enc::Encoder> encoder = enc::from_filename("frame." + ext, &renderer.thread_pool());
+        enc::Bytes bytes = encoder->encode(img);
+
+        lock_guard<mutex> lock(*job.out_mutex);
+        *job.out << "frame " << job.name << " " << encoder->extension() << " " << bytes.size() << "\n";
+        job.out->write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        job.out->flush();
+        return;
+    }
+
+    enc::from_filename(job.output, &renderer.thread_pool())->write(img, job.output);
+
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    reply(job, "done " + job.name + " " + numtostr(ms) + " " + job.output);
+}
+
+string RenderServer::define_scene(istream& in, istringstream& args){
+    SceneEntry entry;
+    string name;
+    try{
+        name = read<string>(args, "scene name");
+        entry.dim = read<size_t>(args, "scene dimension");
+        if(entry.dim == 3){
+            read_objects(in, entry.scene3);
+        }
+        else if(entry.dim == 4){
+            read_objects(in, entry.scene4);
+        }
+        else{
+            throw string("RenderServer: scenes are 3 or 4 dimensional");
+        }
+    }
+    catch(...){
+        skip_block(in);
+        throw;
+    }
+
+    lock_guard<mutex> lock(m);
+    entry.version = next_version++;
+    scenes[name] = entry;
+    return name;
+}
+
+RenderServer::Job RenderServer::read_job(istream& in, istringstream& args){
+    Job job;
+    job.name = read<string>(args, "job name");
+    job.scene = read<string>(args, "scene name");
+    args >> job.priority;
+
+    string line;
+    while(next_line(in, line)){
+        try{
+            if(read_option(line, job)){
+                return job;
+            }
+        }
+        catch(...){
+            skip_block(in);
+            throw;
+        }
+    }
+    throw string("RenderServer: job without end");
+}
+
+bool RenderServer::read_option(const string& line, Job& job){
+    istringstream opt(line);
+    string key;
+    opt >> key;
+    if(key == "end"){
+        return true;
+    }
+    else if(key == "size"){
+        job.width = read<unsigned>(opt, "width");
+        job.height = read<unsigned>(opt, "height");
+    }
+    else if(key == "fov"){
+        job.fov = read<double>(opt, "fov");
+    }
+    else if(key == "position"){
+        double x;
+        job.position.clear();
+        while(opt >> x){
+            job.position.push_back(x);
+        }
+    }
+    else if(key == "turn"){
+        Turn t;
+        t.a = read<size_t>(opt, "turn plane");
+        t.b = read<size_t>(opt, "turn plane");
+        t.degrees = read<double>(opt, "turn angle");
+        job.turns.push_back(t);
+    }
+    else if(key == "engine"){
+        string e = read<string>(opt, "engine");
+        if(e != "recursive" && e != "wavefront"){
+            throw "RenderServer: unknown engine " + e;
+        }
+        job.engine = e == "wavefront" ? Engine::wavefront : Engine::recursive;
+    }
+    else if(key == "lights"){
+        job.light_samples = read<size_t>(opt, "light samples");
+    }
+    else if(key == "area"){
+        job.area_samples = read<size_t>(opt, "area samples");
+    }
+    else if(key == "denoise"){
+        job.denoise = true;
+    }
+    else if(key == "label"){
+        job.label_x = read<size_t>(opt, "label x");
+        job.label_y = read<size_t>(opt, "label y");
+        job.label_scale = read<double>(opt, "label scale");
+        getline(opt >> ws, job.label);
+    }
+    else if(key == "output"){
+        job.output = read<string>(opt, "output");
+    }
+    else{
+        throw "RenderServer: unknown job option " + key;
+    }
+    return false;
+}
+
+bool RenderServer::serve(istream& in, ostream& out){
+    mutex out_mutex;
+    auto send = [&](const string& s){
+        lock_guard<mutex> lock(out_mutex);
+        out << s << endl;
+    };
+
+    bool shutdown = false;
+    string line;
+    while(next_line(in, line)){
+        istringstream args(line);
+        string command;
+        args >> command;
+
+        try{
+            if(command == "scene"){
+                send("scene " + define_scene(in, args));
+            }
+            else if(command == "render"){
+                Job job = read_job(in, args);
+                job.out = &out;
+                job.out_mutex = &out_mutex;
+
+                lock_guard<mutex> lock(m);
+                job.order = next_order++;
+                queue.push_back(job);
+                pending++;
+                send("queued " + job.name);
+                cv.notify_all();
+            }
+            else if(command == "cancel"){
+                string name = read<string>(args, "job name");
+                lock_guard<mutex> lock(m);
+                auto it = find_if(queue.begin(), queue.end(), [&](const Job& j){ return j.name == name; });
+                if(it != queue.end()){
+                    queue.erase(it);
+                    pending--;
+                    send("cancelled " + name);
+                    cv.notify_all();
+                }
+                else if(running == name && rendered){
+                    send("cancel too late " + name);
+                }
+                else if(running == name){
+                    // the worker replies once the frame stops
+                    abort = true;
+                }
+                else{
+                    send("error unknown job " + name);
+                }
+            }
+            else if(command == "status"){
+                lock_guard<mutex> lock(m);
+                string s = "status running " + (running.empty() ? string("-") : running) + " queued";
+                for(const Job& j : queue){
+                    s += " " + j.name;
+                }
+                send(s);
+            }
+            else if(command == "quit"){
+                break;
+            }
+            else if(command == "shutdown"){
+                shutdown = true;
+                break;
+            }
+            else{
+                send("error unknown command " + command);
+            }
+        }
+        catch(const char* e){
+            send(string("error ") + e);
+        }
+        catch(const string& e){
+            send("error " + e);
+        }
+        catch(const exception& e){
+            send(string("error ") + e.what());
+        }
+    }
+
+    // the replies of the queued jobs go to out
+    unique_lock<mutex> lock(m);
+    cv.wait(lock, [this]{ return pending == 0; });
+    return shutdown;
+}
+
+#ifdef RENDERSERVER_SOCKETS
+
+// buffered iostream over a socket
+class SocketBuffer : public streambuf{
+    int fd;
+    char in[1 << 16];
+    char out[1 << 16];
+
+public:
+    explicit SocketBuffer(int fd) : fd(fd) {
+        setg(in, in, in);
+        setp(out, out + sizeof(out));
+    }
+
+    ~SocketBuffer() {sync();}
+
+protected:
+    int underflow() override {
+        ssize_t n = ::read(fd, in, sizeof(in));
+        if(n <= 0){
+            return traits_type::eof();
+        }
+        setg(in, in, in + n);
+        return traits_type::to_int_type(in[0]);
+    }
+
+    int overflow(int c) override {
+        if(sync() != 0){
+            return traits_type::eof();
+        }
+        if(c != traits_type::eof()){
+            *pptr() = char(c);
+            pbump(1);
+        }
+        return c == traits_type::eof() ? 0 : c;
+    }
+
+    int sync() override {
+        char* p = pbase();
+        while(p < pptr()){
+            ssize_t n = ::write(fd, p, pptr() - p);
+            if(n <= 0){
+                return -1;
+            }
+            p += n;
+        }
+        setp(out, out + sizeof(out));
+        return 0;
+    }
+};
+
+void RenderServer::listen(const string& path){
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(server < 0){
+        throw ios_base::failure("RenderServer: creating the socket went wrong");
+    }
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(address.sun_path)){
+        close(server);
+        throw ios_base::failure("RenderServer: socket path too long");
+    }
+    copy(path.begin(), path.end(), address.sun_path);
+
+    unlink(path.c_str());
+    if(bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(server, 8) != 0){
+        close(server);
+        throw ios_base::failure("RenderServer: binding " + path + " went wrong");
+    }
+
+    bool shutdown = false;
+    while(!shutdown){
+        int client = accept(server, nullptr, nullptr);
+        if(client < 0){
+            continue;
+        }
+        {
+            SocketBuffer buffer(client);
+            istream in(&buffer);
+            ostream out(&buffer);
+            shutdown = serve(in, out);
+        }
+        close(client);
+    }
+
+    close(server);
+    unlink(path.c_str());
+}
+
+#else
+
+void RenderServer::listen(const string&){
+    throw ios_base::failure("RenderServer: unix sockets aren't supported here, use serve()");
+}
+
+#endif
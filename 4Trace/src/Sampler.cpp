@@ -0,0 +1,71 @@
+#include "Sampler.h"
+
+#include <cmath>
+
+#include "utils.h"
+
+using namespace std;
+
+
+// finalizer of splitmix64, spreads close seeds over the whole range
+static uint64_t mix64(uint64_t z){
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+Sampler::Sampler(uint64_t seed) : seed(seed){
+    start(0);
+}
+
+void Sampler::start(uint64_t pixel, uint64_t frame){
+    uint64_t key = mix64(seed ^ mix64(frame));
+    increment = (mix64(key ^ pixel) << 1) | 1;
+    state = mix64(key + pixel);
+    next_uint();
+}
+
+uint32_t Sampler::next_uint(){
+    uint64_t old = state;
+    state = old * 6364136223846793005ull + increment;
+    uint32_t xorshifted = ((old >> 18) ^ old) >> 27;
+    uint32_t rot = old >> 59;
+    return (xorshifted >> rot) | (xorshifted << ((32 - rot) & 31));
+}
+
+double Sampler::next(){
+    return next_uint() * (1. / 4294967296.);
+}
+
+void Sampler::r2(uint64_t n, double du, double dv, double& u, double& v){
+    // 1 / g and 1 / g^2, g being the plastic number
+    constexpr double a1 = 0.7548776662466927;
+    constexpr double a2 = 0.5698402909980532;
+
+    u = 0.5 + a1 * n + du;
+    v = 0.5 + a2 * n + dv;
+    u -= floor(u);
+    v -= floor(v);
+}
+
+void Sampler::disk(double u, double v, double& x, double& y){
+    double a = 2 * u - 1;
+    double b = 2 * v - 1;
+    if(a == 0 && b == 0){
+        x = y = 0;
+        return;
+    }
+
+    double r, phi;
+    if(fabs(a) > fabs(b)){
+        r = a;
+        phi = (M_PI / 4) * (b / a);
+    }
+    else{
+        r = b;
+        phi = (M_PI / 2) - (M_PI / 4) * (a / b);
+    }
+    x = r * cos(phi);
+    y = r * sin(phi);
+}
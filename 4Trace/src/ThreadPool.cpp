@@ -0,0 +1,99 @@
+#include "ThreadPool.h"
+
+using namespace std;
+
+
+ThreadPool::ThreadPool(size_t nthreads) :
+    job(nullptr),
+    context(nullptr),
+    njobs(0),
+    next_job(0),
+    active(0),
+    generation(0),
+    stop(false)
+{
+    for(size_t i = 1; i < nthreads; i++){
+        workers.push_back(thread(&ThreadPool::work, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        lock_guard<mutex> lock(m);
+        stop = true;
+    }
+    cv_start.notify_all();
+
+    for(thread& t : workers){
+        t.join();
+    }
+}
+
+void ThreadPool::drain(size_t worker){
+    size_t i;
+    while((i = next_job.fetch_add(1)) < njobs){
+        try{
+            job(context, i, worker);
+        }
+        catch(...){
+            lock_guard<mutex> lock(m);
+            if(!error){
+                error = current_exception();
+            }
+            next_job = njobs;
+        }
+    }
+}
+
+void ThreadPool::work(size_t worker){
+    size_t seen = 0;
+
+    while(true){
+        unique_lock<mutex> lock(m);
+        cv_start.wait(lock, [&](){return stop || generation != seen;});
+        if(stop){
+            return;
+        }
+        seen = generation;
+        lock.unlock();
+
+        drain(worker);
+
+        lock.lock();
+        if(--active == 0){
+            cv_done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::run(size_t njobs, Job job, void* context){
+    if(workers.empty() || njobs <= 1){
+        for(size_t i = 0; i < njobs; i++){
+            job(context, i, 0);
+        }
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(m);
+        this->job = job;
+        this->context = context;
+        this->njobs = njobs;
+        next_job = 0;
+        active = workers.size();
+        generation++;
+    }
+    cv_start.notify_all();
+
+    drain(0);
+
+    unique_lock<mutex> lock(m);
+    cv_done.wait(lock, [&](){return active == 0;});
+
+    // the workers are done with job and context, the caller's frame can go
+    if(error){
+        exception_ptr e = error;
+        error = nullptr;
+        rethrow_exception(e);
+    }
+}
@@ -0,0 +1,208 @@
+#include "TileFarm.h"
+
+#include <ios>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cerrno>
+#define TILEFARM_POSIX
+#endif
+
+using namespace std;
+using namespace farm;
+
+
+#ifdef TILEFARM_POSIX
+
+static bool write_all(int fd, const void* data, size_t size){
+    const char* p = static_cast<const char*>(data);
+    while(size > 0){
+        ssize_t n = ::write(fd, p, size);
+        if(n < 0 && errno == EINTR){
+            continue;
+        }
+        if(n <= 0){
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+static bool read_all(int fd, void* data, size_t size){
+    char* p = static_cast<char*>(data);
+    while(size > 0){
+        ssize_t n = ::read(fd, p, size);
+        if(n < 0 && errno == EINTR){
+            continue;
+        }
+        if(n <= 0){
+            return false;
+        }
+        p += n;
+        size -= n;
+    }
+    return true;
+}
+
+bool farm::send(int fd, uint32_t type, const Bytes& payload){
+    uint64_t size = payload.size();
+    return write_all(fd, &type, sizeof(type)) &&
+           write_all(fd, &size, sizeof(size)) &&
+           write_all(fd, payload.data(), payload.size());
+}
+
+bool farm::receive(int fd, uint32_t& type, Bytes& payload){
+    uint64_t size;
+    if(!read_all(fd, &type, sizeof(type)) || !read_all(fd, &size, sizeof(size))){
+        return false;
+    }
+    payload.resize(size);
+    return read_all(fd, payload.data(), size);
+}
+
+
+void Workers::spawn(size_t n, const function<void(int)>& child){
+    // a worker that dies must not kill the coordinator while writing
+    signal(SIGPIPE, SIG_IGN);
+
+    for(size_t i = 0; i < n; i++){
+        int sv[2];
+        if(socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0){
+            // the constructor throws, the destructor won't reap them
+            stop();
+            throw ios_base::failure("farm: creating the socket pair went wrong");
+        }
+
+        pid_t pid = fork();
+        if(pid < 0){
+            close(sv[0]);
+            close(sv[1]);
+            stop();
+            throw ios_base::failure("farm: starting a worker went wrong");
+        }
+        if(pid == 0){
+            // the other workers' sockets stay with the coordinator
+            for(int fd : fds){
+                close(fd);
+            }
+            close(sv[0]);
+            // nothing may unwind into the copy of the coordinator's stack
+            try{
+                child(sv[1]);
+            }
+            catch(...){
+                _exit(1);
+            }
+            _exit(127);
+        }
+
+        close(sv[1]);
+        fds.push_back(sv[0]);
+        pids.push_back(pid);
+    }
+}
+
+Workers::Workers(size_t n, const function<int(int)>& body){
+    spawn(n, [&](int fd){ _exit(body(fd)); });
+}
+
+Workers::Workers(size_t n, const string& command){
+    spawn(n, [&](int fd){
+        dup2(fd, 0);
+        dup2(fd, 1);
+        close(fd);
+        execl("/bin/sh", "sh", "-c", command.c_str(), (char*)nullptr);
+    });
+}
+
+Workers::~Workers(){
+    stop();
+}
+
+void Workers::stop(){
+    for(size_t i = 0; i < fds.size(); i++){
+        if(fds[i] >= 0){
+            send(fds[i], QUIT, Bytes());
+            close(fds[i]);
+        }
+    }
+    for(int pid : pids){
+        waitpid(pid, nullptr, 0);
+    }
+    fds.clear();
+    pids.clear();
+}
+
+vector<size_t> Workers::ready() const{
+    vector<pollfd> polled;
+    vector<size_t> index;
+    for(size_t i = 0; i < fds.size(); i++){
+        if(fds[i] >= 0){
+            polled.push_back(pollfd{fds[i], POLLIN, 0});
+            index.push_back(i);
+        }
+    }
+
+    vector<size_t> result;
+    if(polled.empty()){
+        return result;
+    }
+    while(poll(polled.data(), polled.size(), -1) < 0){
+        if(errno != EINTR){
+            throw ios_base::failure("farm: waiting for the workers went wrong");
+        }
+    }
+    for(size_t k = 0; k < polled.size(); k++){
+        if(polled[k].revents){
+            result.push_back(index[k]);
+        }
+    }
+    return result;
+}
+
+void Workers::drop(size_t worker){
+    if(fds[worker] >= 0){
+        close(fds[worker]);
+        fds[worker] = -1;
+    }
+}
+
+#else
+
+bool farm::send(int, uint32_t, const Bytes&){
+    return false;
+}
+
+bool farm::receive(int, uint32_t&, Bytes&){
+    return false;
+}
+
+void Workers::spawn(size_t, const function<void(int)>&){
+    throw ios_base::failure("farm: worker processes need POSIX");
+}
+
+Workers::Workers(size_t n, const function<int(int)>& body){
+    spawn(n, [&](int fd){ body(fd); });
+}
+
+Workers::Workers(size_t n, const string&){
+    spawn(n, [](int){});
+}
+
+Workers::~Workers(){}
+
+void Workers::stop(){}
+
+vector<size_t> Workers::ready() const{
+    return vector<size_t>();
+}
+
+void Workers::drop(size_t){}
+
+#endif
@@ -3,10 +3,31 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
+#include <cstring>
+#if defined(__linux__)
+#include <unistd.h>
+#endif
 
 #include <vec.tpp>
 #include <mat.tpp>
 #include <bmp.h>
+#include <Encoder.h>
+#include <VideoStream.h>
+#include <camera.tpp>
+#include <animation.tpp>
+#include <ThreadPool.h>
+#include <primitives.tpp>
+#include <raytracer.tpp>
+#include <Sampler.h>
+#include <Denoiser.h>
+#include <Arena.h>
+#include <RenderServer.h>
+#include <FrameCache.h>
+#include <distributed.tpp>
+#include <cloud.tpp>
+#include <slices.tpp>
+#include <Glyphs.h>
+#include <ImageOps.h>
 
 using namespace std;
 
@@ -164,3 +185,1318 @@ void UnitTest::test_bmp(){
     string image_copy_filename = ".\\test_bmp_images\\test_24bit_9x5_copy.bmp";
     im.write(image_copy_filename);
 }
+
+
+
+// reference decoders for the encoder round trips, the pixels are rgba
+// row by row from the top
+
+// https://qoiformat.org/qoi-specification.pdf
+static vector<uint8_t> qoi_decode(const enc::Bytes& in, size_t& width, size_t& height){
+    auto be32 = [&](size_t p){return uint32_t(in[p]) << 24 | in[p + 1] << 16 | in[p + 2] << 8 | in[p + 3];};
+    width = be32(4);
+    height = be32(8);
+
+    vector<uint8_t> out;
+    uint8_t index[64][4] = {{0}};
+    uint8_t px[4] = {0, 0, 0, 255};
+    size_t p = 14;
+    while(out.size() < 4 * width * height && p + 8 <= in.size()){
+        uint8_t op = in[p++];
+        size_t run = 1;
+        if(op == 0xFE){
+            px[0] = in[p]; px[1] = in[p + 1]; px[2] = in[p + 2];
+            p += 3;
+        }
+        else if(op == 0xFF){
+            memcpy(px, &in[p], 4);
+            p += 4;
+        }
+        else if((op & 0xC0) == 0x00){
+            memcpy(px, index[op], 4);
+        }
+        else if((op & 0xC0) == 0x40){
+            px[0] += ((op >> 4) & 3) - 2;
+            px[1] += ((op >> 2) & 3) - 2;
+            px[2] += (op & 3) - 2;
+        }
+        else if((op & 0xC0) == 0x80){
+            int dg = (op & 0x3F) - 32;
+            px[0] += dg + (in[p] >> 4) - 8;
+            px[1] += dg;
+            px[2] += dg + (in[p] & 0x0F) - 8;
+            p++;
+        }
+        else{
+            run = (op & 0x3F) + 1;
+        }
+        memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) % 64], px, 4);
+        for(size_t k = 0; k < run; k++){
+            out.insert(out.end(), px, px + 4);
+        }
+    }
+    return out;
+}
+
+// only what PNGEncoder writes: 8 bit rgb, stored deflate blocks, no
+// filters. Empty if a checksum or the layout is wrong
+static vector<uint8_t> png_decode(const enc::Bytes& in, size_t& width, size_t& height){
+    auto be32 = [&](size_t p){return uint32_t(in[p]) << 24 | in[p + 1] << 16 | in[p + 2] << 8 | in[p + 3];};
+    vector<uint8_t> zlib, out;
+    width = height = 0;
+
+    for(size_t p = 8; p + 12 <= in.size(); ){
+        size_t length = be32(p);
+        string type(in.begin() + p + 4, in.begin() + p + 8);
+        if(p + 12 + length > in.size() || enc::crc32(&in[p + 4], 4 + length) != be32(p + 8 + length)){
+            return out;
+        }
+        if(type == "IHDR"){
+            width = be32(p + 8);
+            height = be32(p + 12);
+            if(in[p + 16] != 8 || in[p + 17] != 2){
+                return out;
+            }
+        }
+        else if(type == "IDAT"){
+            zlib.insert(zlib.end(), in.begin() + p + 8, in.begin() + p + 8 + length);
+        }
+        p += 12 + length;
+    }
+
+    vector<uint8_t> raw;
+    size_t p = 2;
+    bool last = zlib.size() < 6;
+    while(!last && p + 5 <= zlib.size()){
+        last = zlib[p] & 1;
+        if(zlib[p] & 6){
+            return out;
+        }
+        size_t len = zlib[p + 1] | zlib[p + 2] << 8;
+        raw.insert(raw.end(), zlib.begin() + p + 5, zlib.begin() + min(zlib.size(), p + 5 + len));
+        p += 5 + len;
+    }
+    if(raw.size() != (1 + 3 * width) * height || p + 4 != zlib.size() ||
+       enc::adler32(raw.data(), raw.size()) != (uint32_t(zlib[p]) << 24 | zlib[p + 1] << 16 | zlib[p + 2] << 8 | zlib[p + 3])){
+        return out;
+    }
+
+    for(size_t y = 0; y < height; y++){
+        const uint8_t* row = &raw[y * (1 + 3 * width)];
+        if(row[0] != 0){
+            return vector<uint8_t>();
+        }
+        for(size_t x = 0; x < width; x++){
+            out.insert(out.end(), row + 1 + 3 * x, row + 4 + 3 * x);
+            out.push_back(255);
+        }
+    }
+    return out;
+}
+
+static vector<uint8_t> rgba(const bmp::Image& img){
+    vector<uint8_t> out;
+    for(int y = 0; y < img.height(); y++){
+        for(int x = 0; x < img.width(); x++){
+            bmp::Color c = img.pixelArray.get(x, y);
+            out.insert(out.end(), {c.x(), c.y(), c.z(), 255});
+        }
+    }
+    return out;
+}
+
+void UnitTest::test_encoders(){
+
+    // https://reveng.sourceforge.io/crc-catalogue/ check value
+    const string check = "123456789";
+    utv_test("Test crc32", enc::crc32((const uint8_t*) check.data(), check.size()) == 0xCBF43926);
+
+    // https://en.wikipedia.org/wiki/Adler-32
+    const string wiki = "Wikipedia";
+    utv_test("Test adler32", enc::adler32((const uint8_t*) wiki.data(), wiki.size()) == 0x11E60398);
+
+    bmp::Image im(9, 5);
+    for(size_t i = 0; i < 9; i++){
+        for(size_t j = 0; j < 5; j++){
+            im.pixelArray.set(i, j, bmp::Color(i * 20, j * 40, 100));
+        }
+    }
+
+    enc::Bytes ppm = enc::PPMEncoder().encode(im);
+    utv_test("Test ppm size", ppm.size() == string("P6\n9 5\n255\n").size() + 9 * 5 * 3);
+    utv_test("Test ppm first pixel", ppm[11] == 0 && ppm[12] == 0 && ppm[13] == 100);
+
+    // the bmp encoder has to produce the same pixel array as bmp::Image::write
+    ThreadPool pool(4);
+    enc::Bytes bmp_serial = enc::BMPEncoder().encode(im);
+    enc::Bytes bmp_strips = enc::BMPEncoder(&pool).encode(im);
+    utv_test("Test bmp size", bmp_serial.size() == 14 + 40 + 5 * 28);
+    utv_test("Test bmp strips", bmp_serial == bmp_strips);
+
+    enc::Bytes qoi = enc::QOIEncoder().encode(im);
+    utv_test("Test qoi magic", qoi[0] == 'q' && qoi[1] == 'o' && qoi[2] == 'i' && qoi[3] == 'f');
+    utv_test("Test qoi end marker", qoi[qoi.size() - 2] == 0 && qoi[qoi.size() - 1] == 1);
+
+    enc::Bytes png = enc::PNGEncoder().encode(im);
+    utv_test("Test png signature", png[0] == 137 && png[1] == 'P' && png[2] == 'N' && png[3] == 'G');
+    utv_test("Test png size", png.size() == 8 + 25 + 12 + 2 + 5 + 5 * 28 + 4 + 12);
+
+    // round trips, with runs, diffs, lumas, index hits and black after
+    // colour, which must not hit the empty index slot of (0, 0, 0, 0)
+    bmp::Image mixed(70, 40);
+    for(int i = 0; i < 70; i++){
+        for(int j = 0; j < 40; j++){
+            bmp::Color c(i * 3, j * 5, (i * j) % 7);
+            if(i % 9 == 4){
+                c = bmp::Color(0);
+            }
+            else if(i % 5 == 0){
+                c = bmp::Color(200, 10, 30);
+            }
+            else if(j > 30){
+                c = bmp::Color(i * 3 + j % 2, j * 5 - j % 3, 40);
+            }
+            mixed.pixelArray.set(i, j, c);
+        }
+    }
+    size_t width, height;
+    bool qoi_trip = true, png_trip = true;
+    for(const bmp::Image* img : {&im, &mixed}){
+        qoi_trip = qoi_trip && qoi_decode(enc::QOIEncoder().encode(*img), width, height) == rgba(*img) &&
+                               int(width) == img->width() && int(height) == img->height();
+        png_trip = png_trip && png_decode(enc::PNGEncoder(&pool).encode(*img), width, height) == rgba(*img) &&
+                               int(width) == img->width() && int(height) == img->height();
+    }
+    utv_test("Test qoi round trip", qoi_trip);
+    utv_test("Test png round trip", png_trip);
+
+    enc::BMPEncoder().write(im, ".\\test_bmp_images\\test_encoder_9x5_enc.bmp");
+    bmp::Image reread(".\\test_bmp_images\\test_encoder_9x5_enc.bmp");
+    utv_test("Test bmp read back", reread.pixelArray == im.pixelArray);
+}
+
+
+
+void UnitTest::test_video_stream(){
+
+    bmp::Image frame(9, 5);
+    for(size_t i = 0; i < 9; i++){
+        for(size_t j = 0; j < 5; j++){
+            frame.pixelArray.set(i, j, bmp::Color(255, 255, 255));
+        }
+    }
+
+    string y4m_filename = ".\\test_bmp_images\\test_stream.y4m";
+    {
+        enc::VideoStream stream(y4m_filename, enc::VideoStream::Y4M);
+        stream.write(frame);
+        stream.write(frame);
+        utv_test("Test frame count", stream.frames() == 2);
+    }
+
+    string header = "YUV4MPEG2 W9 H5 F25:1 Ip A1:1 C444\n";
+    ifstream y4m(y4m_filename, ios::binary | ios::ate);
+    utv_test("Test y4m size", size_t(y4m.tellg()) == header.size() + 2 * (6 + 3 * 9 * 5));
+
+    // white is Y = 235, Cb = Cr = 128 in limited range
+    y4m.seekg(header.size() + 6);
+    char yuv[3];
+    y4m.read(yuv, 1);
+    y4m.seekg(header.size() + 6 + 9 * 5);
+    y4m.read(yuv + 1, 1);
+    utv_test("Test y4m white", uint8_t(yuv[0]) == 235 && uint8_t(yuv[1]) == 128);
+
+    string raw_filename = ".\\test_bmp_images\\test_stream.rgb";
+    {
+        enc::VideoStream stream(raw_filename, enc::VideoStream::RAW_RGB);
+        stream.write(frame);
+    }
+    ifstream raw(raw_filename, ios::binary | ios::ate);
+    utv_test("Test raw size", size_t(raw.tellg()) == 3 * 9 * 5);
+}
+
+
+
+void UnitTest::test_camera(){
+
+    // default camera: the center pixel of a 3x3 image looks down -z
+    Camera<4> cam(3, 3, 90);
+    Vector<double, 4> d00, dx, dy;
+    cam.ray_deltas(d00, dx, dy);
+    Vector<double, 4> center = d00 + dx + dy;
+    utv_test("Test camera center ray", center.cmp_close(V4d(0, 0, -1, 0)));
+    utv_test("Test camera corner ray", d00.cmp_close(V4d(-2 / 3., -2 / 3., -1, 0)));
+
+    // a quarter turn in the (z, w) plane looks down -w
+    cam.turn(2, 3, 90);
+    utv_test("Test camera turn", cam.forward().cmp_close(V4d(0, 0, 0, -1)));
+    utv_test("Test camera basis", close(cam.axes[2].dot(cam.axes[3]), 0) && close(cam.axes[3].length(), 1));
+
+    // the point is 4 units in front of the camera, so at local z = -4
+    cam.position = V4d(1, 2, 3, 4);
+    utv_test("Test camera frame", cam.to_camera(V4d(1, 2, 3, 0)).cmp_close(V4d(0, 0, -4, 0)));
+
+    Track<double> track;
+    track.key(10, 1).key(0, -1);
+    utv_test("Test track interpolation", close(track.at(5), 0));
+    utv_test("Test track clamp", track.at(-3) == -1 && track.at(20) == 1);
+}
+
+
+
+void UnitTest::test_thread_pool(){
+
+    ThreadPool pool(4);
+    utv_test("Test pool size", pool.size() == 4);
+
+    // every job runs exactly once, over several batches
+    vector<int> counts(1000, 0);
+    auto job = [&](size_t i, size_t){ counts[i]++; };
+    for(int batch = 0; batch < 3; batch++){
+        pool.parallel_for(counts.size(), job);
+    }
+
+    bool all_three = true;
+    for(int c : counts){
+        all_three = all_three && (c == 3);
+    }
+    utv_test("Test pool jobs", all_three);
+
+    // a throwing job ends the batch, the pool stays usable
+    auto failing = [&](size_t i, size_t){ if(i % 100 == 50) {throw "job failed";} };
+    string caught;
+    try{
+        pool.parallel_for(1000, failing);
+    }
+    catch(const char* e){
+        caught = e;
+    }
+    fill(counts.begin(), counts.end(), 0);
+    pool.parallel_for(counts.size(), job);
+    utv_test("Test pool job exception", caught == "job failed" && count(counts.begin(), counts.end(), 1) == 1000);
+
+    ThreadPool inline_pool(1);
+    size_t max_worker = 0;
+    auto worker_job = [&](size_t, size_t worker){ max_worker = max(max_worker, worker); };
+    inline_pool.parallel_for(10, worker_job);
+    utv_test("Test inline pool", max_worker == 0);
+}
+
+
+
+void UnitTest::test_primitives(){
+
+    V4d origin(0, 0, 0, 0);
+    V4d down(0, -1, 0, 0);
+
+    Plane<4> floor(V4d(0, -4, 0, 0), V4d(0, 2, 0, 0), Color(1), Color(0), 0, 0);
+    double t = 0;
+    utv_test("Test plane normalized", floor.n == V4d(0, 1, 0, 0));
+    utv_test("Test plane hit", floor.intersect(origin, down, t) && close(t, 4));
+    utv_test("Test plane miss behind", !floor.intersect(origin, V4d(0, 1, 0, 0), t));
+
+    Box<4> box(V4d(-1, -3, -1, -1), V4d(1, -2, 1, 1), Color(1), Color(0), 0, 0);
+    double t0 = 0, t1 = 0;
+    utv_test("Test box hit", box.intersect(origin, down, t0, t1) && close(t0, 2) && close(t1, 3));
+    utv_test("Test box normal", box.normal(V4d(0, -2, 0, 0)) == V4d(0, 1, 0, 0));
+
+    // the 4D rays have w = 0, a box out of the w = 0 slice is never hit
+    Box<4> away(V4d(-1, -3, -1, 2), V4d(1, -2, 1, 3), Color(1), Color(0), 0, 0);
+    utv_test("Test box out of slice", !away.intersect(origin, down, t0, t1));
+}
+
+// scene with every material class, used by the engine tests
+static Scene<4> test_scene(){
+    Scene<4> scene;
+    scene.planes.push_back(Plane<4>(V4d(0, -4, 0, 0), V4d(0, 1, 0, 0), Color(0.2), Color(0), 0, 0));
+    scene.spheres.push_back(Sphere<4>(V4d( 0, 0, -20, 0), 4, Color(1, 0.3, 0.3), Color(0), 0.5, 0.1));
+    scene.spheres.push_back(Sphere<4>(V4d( 5, -1, -15, 0), 2, Color(0.9, 0.8, 0.5), Color(0), 0, 0.6));
+    scene.spheres.push_back(Sphere<4>(V4d(-5, 0, -25, 1), 3, Color(0.6, 0.8, 1), Color(0), 0, 0));
+    scene.spheres.push_back(Sphere<4>(V4d( 0, 20, -20, 0), 3, Color(0), Color(3), 0, 0));
+    scene.boxes.push_back(Box<4>(V4d(-8, -4, -18, -1), V4d(-6, -2, -16, 1), Color(0.3, 1, 0.3), Color(0), 0, 0));
+    return scene;
+}
+
+// largest difference of a channel between two images of the same size
+static int max_difference(const bmp::Image& a, const bmp::Image& b){
+    int diff = 0;
+    for(int i = 0; i < a.width(); i++){
+        for(int j = 0; j < a.height(); j++){
+            bmp::Color ca = a.pixelArray.get(i, j);
+            bmp::Color cb = b.pixelArray.get(i, j);
+            for(size_t k = 0; k < 3; k++){
+                diff = max(diff, abs(int(ca[k]) - int(cb[k])));
+            }
+        }
+    }
+    return diff;
+}
+
+void UnitTest::test_wavefront(){
+    Scene<4> scene = test_scene();
+    Camera<4> camera(96, 64);
+
+    bmp::Image recursive = render<4>(scene, camera, Engine::recursive);
+    bmp::Image wavefront = render<4>(scene, camera, Engine::wavefront);
+
+    // same rays and hits, only the order of the sums changes
+    utv_test("Test wavefront matches recursive", max_difference(recursive, wavefront) <= 1);
+
+    Renderer<4> renderer(camera, 3, Engine::wavefront);
+    renderer.scene() = scene;
+    utv_test("Test wavefront threaded", max_difference(renderer.render(), wavefront) == 0);
+
+    utv_test("Test material class", material_class(scene.spheres[0], 0) == MaterialClass::refractive &&
+                                    material_class(scene.spheres[0], MAX_RAY_DEPTH) == MaterialClass::diffuse &&
+                                    material_class(scene.spheres[3], 0) == MaterialClass::emissive);
+}
+
+void UnitTest::test_primary_rays(){
+    Scene<4> scene = test_scene();
+    Camera<4> camera(96, 64);
+    camera.position = V4d(1, 0.5, 2, 0.2);
+    camera.turn(0, 2, 10);
+
+    OriginCache<4> cache;
+    cache.build(scene, camera.position);
+
+    TileGrid grid;
+    build_tiles(scene, camera, grid);
+
+    Vector<double, 4> d00, dx, dy;
+    camera.ray_deltas(d00, dx, dy);
+
+    // every pixel must find the same hit with the cached constants and
+    // with the culled candidates of its tile
+    bool same = true;
+    for(size_t i = 0; i < camera.width; i++){
+        for(size_t j = 0; j < camera.height; j++){
+            Vector<double, 4> raydir = d00 + dx * double(i) + dy * double(j);
+            raydir.normalize();
+
+            const Tile& tile = grid.tile(i / TILE_SIZE, j / TILE_SIZE);
+            Hit full = closest_hit(camera.position, raydir, scene);
+            Hit primary = primary_hit(raydir, scene, cache, &tile);
+
+            same = same && full.shape == primary.shape && full.index == primary.index &&
+                   (!full || fabs(full.t - primary.t) < 1e-9);
+        }
+    }
+    utv_test("Test primary hits match", same);
+
+    // the light and the far sphere are only in a few tiles
+    size_t candidates = 0;
+    for(const Tile& tile : grid.tiles){
+        candidates += tile.spheres.size();
+    }
+    utv_test("Test tiles culled", candidates < grid.tiles.size() * scene.spheres.size() / 2);
+}
+
+void UnitTest::test_tile_lists(){
+    Scene<4> scene = test_scene();
+    Camera<4> camera(96, 64);
+    camera.position = V4d(1, 0.5, 2, 0.2);
+    camera.turn(0, 2, 10);
+
+    // every pixel traced against the whole scene, the ray directions
+    // stepped along the rows like the renderer does
+    Vector<double, 4> d00, dx, dy;
+    camera.ray_deltas(d00, dx, dy);
+    bmp::Image full(camera.width, camera.height);
+    for(size_t j = 0; j < camera.height; j++){
+        Vector<double, 4> rowdir = d00 + dy * double(j);
+        for(size_t i = 0; i < camera.width; i++){
+            Vector<double, 4> raydir = rowdir;
+            raydir.normalize();
+            Color pixel = trace(camera.position, raydir, scene, 0);
+            pixel.x(min(1., pixel.x()));
+            pixel.y(min(1., pixel.y()));
+            pixel.z(min(1., pixel.z()));
+            full.pixelArray.set(i, camera.height - 1 - j, bmp::Color(pixel * 255));
+            rowdir += dx;
+        }
+    }
+    utv_test("Test tile lists same image", max_difference(render<4>(scene, camera), full) == 0 &&
+                                           max_difference(render<4>(scene, camera, Engine::wavefront), full) == 0);
+}
+
+void UnitTest::test_slice_mode(){
+    // every object in the hyperplane w = 0 of the camera: the slice and
+    // the 4D trace see the same surfaces and normals
+    Scene<4> scene = test_scene();
+    scene.spheres[2].center[3] = 0;
+    Camera<4> camera(96, 64);
+
+    Scene<3> sliced = slice(scene, camera);
+    utv_test("Test slice objects", sliced.spheres.size() == 4 && sliced.planes.size() == 1 && sliced.boxes.size() == 1);
+    utv_test("Test slice matches render", max_difference(render_slice(scene, camera), render<4>(scene, camera)) == 0);
+
+    // a sphere off the hyperplane shrinks, one past its radius is culled
+    scene.spheres[1].center[3] = 1;
+    scene.spheres[2].center[3] = 3;
+    sliced = slice(scene, camera);
+    utv_test("Test slice radius", sliced.spheres.size() == 3 && close(sliced.spheres[1].radius, sqrt(3.)));
+}
+
+// a floor lit by a row of small lights
+static Scene<3> light_rig(size_t nlights){
+    Scene<3> scene;
+    scene.planes.push_back(Plane<3>(V3d(0, -4, 0), V3d(0, 1, 0), Color(0.8), Color(0), 0, 0));
+    scene.spheres.push_back(Sphere<3>(V3d(0, -2, -20), 2, Color(0.9, 0.5, 0.3), Color(0), 0, 0));
+    for(size_t k = 0; k < nlights; k++){
+        double x = -15 + 30. * k / max<size_t>(1, nlights - 1);
+        scene.spheres.push_back(Sphere<3>(V3d(x, 6, -20 - (k % 3) * 5.), 0.3, Color(0), Color(3. / nlights), 0, 0));
+    }
+    return scene;
+}
+
+void UnitTest::test_lights(){
+    Sampler a(7), b(7);
+    a.start(123, 4);
+    b.start(123, 4);
+    bool same = true, in_range = true;
+    for(int k = 0; k < 100; k++){
+        double u = a.next();
+        same = same && u == b.next();
+        in_range = in_range && u >= 0 && u < 1;
+    }
+    utv_test("Test sampler reproducible", same);
+    utv_test("Test sampler range", in_range);
+    b.start(124, 4);
+    a.start(123, 4);
+    utv_test("Test sampler pixels differ", a.next_uint() != b.next_uint());
+
+    Scene<3> scene = light_rig(12);
+    Lights<3> lights;
+    lights.build(scene);
+    utv_test("Test lights found", lights.size() == 12 && lights.index[0] == 1);
+
+    // the light picking is unbiased: the mean over many pixels matches
+    // the sum over every light
+    V3d phit(3, -4, -18), nhit(0, 1, 0);
+    const Material& floor = scene.planes[0];
+    Color exact = direct_light(phit, nhit, floor, scene, &lights);
+
+    lights.samples = 2;
+    Sampler sampler;
+    Color mean(0);
+    size_t n = 4000;
+    for(size_t k = 0; k < n; k++){
+        sampler.start(k);
+        mean += direct_light(phit, nhit, floor, scene, &lights, &sampler);
+    }
+    mean *= 1. / n;
+    utv_test("Test sampled lights unbiased", fabs(mean[0] - exact[0]) < 0.02 * exact[0]);
+
+    // the seeds depend on the pixel, not on the thread
+    Camera<3> camera(64, 48);
+    Renderer<3> one(camera, 1), three(camera, 3);
+    one.scene() = scene;
+    three.scene() = scene;
+    one.light_samples(2);
+    three.light_samples(2);
+    utv_test("Test sampled lights deterministic", max_difference(one.render(), three.render()) == 0);
+}
+
+void UnitTest::test_soft_shadows(){
+    // 64 R2 points put 4 in every cell of a 4x4 grid, give or take 2
+    size_t cells[16] = {0};
+    bool in_disk = true;
+    for(size_t n = 0; n < 64; n++){
+        double u, v, x, y;
+        Sampler::r2(n, 0.3, 0.7, u, v);
+        cells[size_t(u * 4) * 4 + size_t(v * 4)]++;
+        Sampler::disk(u, v, x, y);
+        in_disk = in_disk && x * x + y * y <= 1 + 1e-12;
+    }
+    bool even = true;
+    for(size_t c : cells){
+        even = even && c >= 2 && c <= 6;
+    }
+    utv_test("Test r2 stratified", even);
+    utv_test("Test disk mapping", in_disk);
+
+    // a ball of radius 1 at height 2 under a light of radius 2 at height 10
+    Scene<3> scene;
+    scene.planes.push_back(Plane<3>(V3d(0, 0, 0), V3d(0, 1, 0), Color(1), Color(0), 0, 0));
+    scene.spheres.push_back(Sphere<3>(V3d(0, 10, 0), 2, Color(0), Color(1), 0, 0));
+    scene.spheres.push_back(Sphere<3>(V3d(0, 2, 0), 1, Color(1), Color(0), 0, 0));
+
+    Lights<3> lights;
+    lights.build(scene);
+    lights.area_samples = 4;
+    lights.area_max_samples = 64;
+    Sampler sampler(1);
+
+    V3d n(0, 1, 0);
+    auto visibility = [&](const V3d& p){
+        V3d l = scene.spheres[0].center - p;
+        double d = l.length();
+        l.normalize();
+        return light_visibility(p, n, l, d, scene, 0, &lights, &sampler);
+    };
+
+    utv_test("Test soft shadow lit", visibility(V3d(6, 0, 0)) == 1);
+    utv_test("Test soft shadow umbra", visibility(V3d(0, 0, 0)) == 0);
+    double penumbra = visibility(V3d(1.3, 0, 0));
+    utv_test("Test soft shadow penumbra", penumbra > 0 && penumbra < 1);
+
+    Camera<3> camera(64, 48);
+    camera.position = V3d(0, 4, 20);
+    Renderer<3> one(camera, 1), three(camera, 3);
+    one.scene() = scene;
+    three.scene() = scene;
+    one.area_lights(4, 16);
+    three.area_lights(4, 16);
+    utv_test("Test soft shadows deterministic", max_difference(one.render(), three.render()) == 0);
+}
+
+void UnitTest::test_denoiser(){
+    // two flat objects side by side, dark and bright, with +-0.2 noise
+    size_t width = 64, height = 32;
+    AuxBuffers aux;
+    aux.resize(width, height);
+
+    Sampler noise(3);
+    float n[3] = {0, 0, 1};
+    for(size_t y = 0; y < height; y++){
+        for(size_t x = 0; x < width; x++){
+            bool right = x >= width / 2;
+            float base = right ? 0.8f : 0.2f;
+            float v = base + 0.4f * (float(noise.next()) - 0.5f);
+            float rgb[3] = {v, v, v};
+            aux.set(x, y, rgb, n, 10, right ? 2 : 1, true);
+        }
+    }
+
+    // mean squared error against the clean image
+    auto error = [&](){
+        double e = 0;
+        for(size_t y = 0; y < height; y++){
+            for(size_t x = 0; x < width; x++){
+                double d = aux.color[3 * (y * width + x)] - (x >= width / 2 ? 0.8 : 0.2);
+                e += d * d;
+            }
+        }
+        return e / (width * height);
+    };
+
+    double before = error();
+    ThreadPool pool(2);
+    Denoiser denoiser;
+    denoiser.denoise(aux, pool);
+    double after = error();
+
+    utv_test("Test denoiser removes noise", after < before / 10);
+
+    // the edge between the objects stays sharp
+    float left = aux.color[3 * (10 * width + width / 2 - 1)];
+    float right = aux.color[3 * (10 * width + width / 2)];
+    utv_test("Test denoiser keeps edges", fabs(left - 0.2f) < 0.1f && fabs(right - 0.8f) < 0.1f);
+
+    // the filtered frame doesn't depend on the threads either
+    Scene<3> scene = light_rig(4);
+    Camera<3> camera(64, 48);
+    Renderer<3> one(camera, 1), three(camera, 3);
+    one.scene() = scene;
+    three.scene() = scene;
+    one.light_samples(1);
+    three.light_samples(1);
+    one.denoise(true);
+    three.denoise(true);
+    utv_test("Test denoised frame deterministic", max_difference(one.render(), three.render()) == 0);
+    utv_test("Test aux buffers", one.aux_buffers().width == 64 && one.aux_buffers().id[0] == 0 &&
+                                 one.aux_buffers().id[64 * 47] == object_id(Hit{1, Shape::plane, 0}));
+}
+
+void UnitTest::test_temporal(){
+    Scene<3> scene = light_rig(4);
+    Camera<3> camera(64, 48);
+
+    // the noiseless frame, every light evaluated
+    Renderer<3> exact(camera);
+    exact.scene() = scene;
+    exact.aux_buffers(true);
+    exact.render();
+    const std::vector<float> reference = exact.aux_buffers().color;
+
+    auto error = [&](const AuxBuffers& aux){
+        double e = 0;
+        for(size_t k = 0; k < reference.size(); k++){
+            double d = aux.color[k] - reference[k];
+            e += d * d;
+        }
+        return e / reference.size();
+    };
+
+    // one light sample per hit, with and without the history
+    Renderer<3> one(camera, 1), three(camera, 3), fresh(camera);
+    for(Renderer<3>* r : {&one, &three, &fresh}){
+        r->scene() = scene;
+        r->light_samples(1);
+    }
+    one.temporal(true);
+    three.temporal(true);
+    fresh.aux_buffers(true);
+
+    one.render();
+    double first = error(one.aux_buffers());
+    for(int f = 1; f < 8; f++){
+        one.render();
+        three.render();
+        fresh.render();
+    }
+    three.render();
+    fresh.render();
+    utv_test("Test temporal converges", error(one.aux_buffers()) < first / 3);
+
+    // the ball moves: its pixels start over, the rest keeps its history.
+    // Only the shadows are noisy, the color of the ball can be compared
+    // with a frame rendered without history
+    size_t still = one.temporal().reused_pixels();
+    for(Renderer<3>* r : {&one, &three, &fresh}){
+        r->scene().spheres[0].center += V3d(1, 0, 0);
+        r->render();
+    }
+    const AuxBuffers& accumulated = one.aux_buffers();
+    const AuxBuffers& single = fresh.aux_buffers();
+    size_t ball = 0, ball_same = 0, floor = 0;
+    for(size_t p = 0; p < accumulated.id.size(); p++){
+        if(accumulated.id[p] == object_id(Hit{1, Shape::sphere, 0})){
+            ball++;
+            ball_same += accumulated.color[3 * p] == single.color[3 * p];
+        }
+        floor += accumulated.id[p] == object_id(Hit{1, Shape::plane, 0});
+    }
+    size_t reused = one.temporal().reused_pixels();
+    utv_test("Test temporal rejects moved object", ball > 0 && ball_same == ball);
+    utv_test("Test temporal keeps static object", reused + ball <= still && reused > floor / 2);
+
+    // a small camera move reuses most of the history
+    for(Renderer<3>* r : {&one, &three}){
+        r->camera().position += V3d(0.2, 0, 0);
+        r->render();
+    }
+    utv_test("Test temporal reprojects", one.temporal().reused_pixels() > floor / 2);
+    utv_test("Test temporal deterministic", max_difference(one.image(), three.image()) == 0);
+}
+
+void UnitTest::test_arena(){
+    Arena arena(256);
+    char* c = arena.allocate<char>(3);
+    double* d = arena.allocate<double>(4);
+    utv_test("Test arena alignment", size_t(d) % alignof(double) == 0 && (void*)(c + 3) <= (void*)d);
+
+    // more than the first block: a second one is chained
+    ArenaArray<uint32_t> big;
+    big.assign(arena, 200, 7);
+    ArenaStats s = arena.stats();
+    utv_test("Test arena grows", s.system_allocations == 2 && big[199] == 7 && s.used >= 800 + 32);
+
+    // the reset folds the chain, the same allocations then fit in one block
+    arena.reset();
+    size_t blocks = arena.stats().system_allocations;
+    arena.allocate<char>(3);
+    arena.allocate<double>(4);
+    big.assign(arena, 200, 7);
+    utv_test("Test arena reuses memory", arena.stats().system_allocations == blocks && arena.stats().peak == s.peak);
+
+    // past the first frame the wavefront batches don't allocate
+    Camera<4> camera(64, 48);
+    Renderer<4> renderer(camera, 2, Engine::wavefront);
+    renderer.scene() = test_scene();
+    renderer.render();
+    renderer.render();
+    size_t allocations = renderer.memory().system_allocations;
+    renderer.render();
+    utv_test("Test wavefront without malloc", renderer.memory().system_allocations == allocations &&
+                                              renderer.memory().peak > 0);
+}
+
+void UnitTest::test_render_server(){
+    RenderServer server(2);
+    istringstream in(
+        "# a floor, a ball and a light\n"
+        "scene rig 3\n"
+        "    plane 0 -4 0  0 1 0  0.8 0.8 0.8  0 0 0  0 0\n"
+        "    sphere 0 -2 -20  2  0.9 0.5 0.3  0 0 0  0 0\n"
+        "    sphere 0 6 -20  0.3  0 0 0  3 3 3  0 0\n"
+        "end\n"
+        "render streamed rig\n"
+        "    size 32 24\n"
+        "    position 0 1 0\n"
+        "end\n"
+        "render bad rig\n"
+        "    size 32 24\n"
+        "    speed 3\n"
+        "end\n"
+        "render lost nowhere\n"
+        "end\n"
+        "cancel nothing\n"
+        "render written rig 5\n"
+        "    size 32 24\n"
+        "    output ./test_bmp_images/test_server.ppm\n"
+        "end\n");
+    ostringstream out;
+    bool shutdown = server.serve(in, out);
+    string replies = out.str();
+
+    // the same frame rendered directly
+    Camera<3> camera(32, 24);
+    camera.position = V3d(0, 1, 0);
+    Renderer<3> renderer(camera);
+    vector<Sphere<3>>& spheres = renderer.scene().spheres;
+    renderer.scene().planes.push_back(Plane<3>(V3d(0, -4, 0), V3d(0, 1, 0), Color(0.8), Color(0), 0, 0));
+    spheres.push_back(Sphere<3>(V3d(0, -2, -20), 2, Color(0.9, 0.5, 0.3), Color(0), 0, 0));
+    spheres.push_back(Sphere<3>(V3d(0, 6, -20), 0.3, Color(0), Color(3), 0, 0));
+    enc::Bytes expected = enc::BMPEncoder().encode(renderer.render());
+
+    string header = "frame streamed bmp " + numtostr(expected.size()) + "\n";
+    size_t at = replies.find(header);
+    bool streamed = at != string::npos &&
+                    replies.compare(at + header.size(), expected.size(), string(expected.begin(), expected.end())) == 0;
+
+    utv_test("Test server session ends", !shutdown);
+    utv_test("Test server scene", replies.find("scene rig\n") != string::npos);
+    utv_test("Test server streams frame", streamed);
+    utv_test("Test server writes frame", replies.find("done written ") != string::npos &&
+                                          ifstream("./test_bmp_images/test_server.ppm").good());
+    utv_test("Test server errors", replies.find("error RenderServer: unknown job option speed") != string::npos &&
+                                   replies.find("error unknown scene nowhere") != string::npos &&
+                                   replies.find("error unknown job nothing") != string::npos);
+    utv_test("Test server skips bad block", replies.find("error unknown command") == string::npos);
+}
+
+void UnitTest::test_frame_cache(){
+    string directory = "./test_bmp_images/test_cache";
+    Camera<3> camera(48, 32);
+    Scene<3> scene = light_rig(3);
+
+    // a 48x32 ppm is 4621 bytes, the bound keeps two frames
+    size_t limit = 2 * 4700;
+    {
+        FrameCache cache(directory, limit);
+        cache.clear();
+
+        Renderer<3> renderer(camera);
+        renderer.scene() = scene;
+        renderer.frame_cache(&cache);
+
+        bmp::Image first = renderer.render();
+        bmp::Image again = renderer.render();
+        utv_test("Test cache hit", cache.stats().hits == 1 && cache.stats().misses == 1 &&
+                                   max_difference(first, again) == 0);
+
+        // the input changes: a miss, both frames are kept
+        renderer.scene().spheres[0].center += V3d(0.5, 0, 0);
+        renderer.render();
+        utv_test("Test cache changed input", cache.stats().misses == 2 && cache.stats().frames == 2);
+
+        // the least recently used frame goes
+        renderer.camera().fov = 40;
+        renderer.render();
+        utv_test("Test cache eviction", cache.stats().evictions == 1 && cache.stats().frames == 2 &&
+                                        cache.stats().bytes <= limit);
+    }
+
+    // a new process finds the frames of the last run
+    FrameCache cache(directory, limit);
+    utv_test("Test cache persistent", cache.stats().frames == 2);
+
+    // the order of use survives the reload: a new frame evicts the older
+    // of the two, the one of fov 40 is still read
+    scene.spheres[0].center += V3d(0.5, 0, 0);
+    Camera<3> wide = camera;
+    wide.fov = 60;
+    render<3>(scene, wide, Engine::recursive, &cache);
+    Camera<3> narrow = camera;
+    narrow.fov = 40;
+    bmp::Image cached = render<3>(scene, narrow, Engine::recursive, &cache);
+    utv_test("Test cache reads frames", cache.stats().hits == 1 && cache.stats().evictions == 1 &&
+                                        max_difference(cached, render<3>(scene, narrow)) == 0);
+
+    // a damaged index loses its bad lines, not the cache
+    ofstream(directory + "/index", ios::app) << "zz-not-a-key 12 3\n0123456789abcdeg 1 1\n00000000";
+    {
+        FrameCache damaged(directory, limit);
+        utv_test("Test cache damaged index", damaged.stats().frames == 2);
+    }
+    cache.clear();
+}
+
+void UnitTest::test_distributed(){
+    Scene<4> scene = test_scene();
+    Camera<4> camera(96, 64);
+
+    DistributedRenderer<4> distributed(camera, 3);
+    distributed.scene() = scene;
+    distributed.light_samples(2);
+
+    Renderer<4> renderer(camera);
+    renderer.scene() = scene;
+    renderer.light_samples(2);
+
+    // same frame numbers, same samples
+    bmp::Image first = distributed.render();
+    utv_test("Test distributed matches renderer", max_difference(first, renderer.render()) == 0);
+
+    size_t busy = 0;
+    for(size_t tiles : distributed.worker_tiles()){
+        busy += tiles > 0;
+    }
+    utv_test("Test distributed load balancing", busy > 1 && distributed.work_units() > 3);
+
+    distributed.engine(Engine::wavefront);
+    renderer.engine(Engine::wavefront);
+    distributed.scene().spheres[0].center += V4d(1, 0, 0, 0);
+    renderer.scene().spheres[0].center += V4d(1, 0, 0, 0);
+    utv_test("Test distributed next frame", max_difference(distributed.render(), renderer.render()) == 0);
+
+#if defined(__linux__)
+    // "4Trace worker" through the shell, the tests run in 4Trace. The
+    // worker taking the lock reads the start of the frame and exits, its
+    // units go to the other two
+    string lock = "./test_bmp_images/test_dead_worker";
+    remove(lock.c_str());
+    char exe[4096];
+    ssize_t length = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    exe[max<ssize_t>(length, 0)] = 0;
+    string command = "mkdir " + lock + " 2>/dev/null && exec head -c 64 >/dev/null; exec '" + string(exe) + "' worker";
+
+    DistributedRenderer<4> remote(camera, 3, command);
+    remote.scene() = scene;
+    remote.light_samples(2);
+    Renderer<4> reference(camera);
+    reference.scene() = scene;
+    reference.light_samples(2);
+    utv_test("Test distributed dead worker", max_difference(remote.render(), reference.render()) == 0 && remote.workers_alive() == 2);
+    remove(lock.c_str());
+#endif
+}
+
+void UnitTest::test_cloud(){
+    string path = "./test_bmp_images/test_cloud.4tc";
+
+    // a slab of small spheres in front of the light rig
+    Sampler random(11);
+    random.start(0, 0);
+    vector<CloudSphere<3>> spheres(8000);
+    for(CloudSphere<3>& s : spheres){
+        s.center[0] = -12 + 24 * random.next();
+        s.center[1] = -4 + 8 * random.next();
+        s.center[2] = -16 - 4 * random.next();
+        s.radius = 0.05 + 0.1 * random.next();
+        s.material = random.next() < 0.1 ? 2 : (random.next() < 0.5 ? 1 : 0);
+    }
+    vector<Material> materials;
+    materials.push_back(Material(Color(0.9, 0.2, 0.2), Color(0), 0, 0));
+    materials.push_back(Material(Color(0.2, 0.9, 0.2), Color(0), 0, 0));
+    materials.push_back(Material(Color(1), Color(0), 0.5, 0.5));
+
+    uint64_t fingerprint = build_cloud<3>(path, spheres, materials, 8, 4096);
+
+    SphereCloud<3> cloud(path, 1 << 20);
+    utv_test("Test cloud header", cloud.size() == spheres.size() && cloud.materials().size() == 3 &&
+                                  cloud.fingerprint() == fingerprint);
+    utv_test("Test cloud compact", ifstream(path, ios::binary | ios::ate).tellg() < streamoff(sizeof(Sphere<3>) * spheres.size() / 4));
+
+    // quantized to a fraction of the extent of a page
+    double error = 0;
+    for(size_t i = 0; i < spheres.size(); i++){
+        Sphere<3> s = cloud.sphere(i);
+        for(size_t k = 0; k < 3; k++){
+            error = max(error, fabs(s.center[k] - spheres[i].center[k]));
+        }
+        error = max(error, fabs(s.radius - spheres[i].radius));
+    }
+    utv_test("Test cloud quantization", error < 1e-3);
+
+    // the same spheres in memory
+    Scene<3> scene = light_rig(1);
+    Scene<3> expanded = scene;
+    for(size_t i = 0; i < cloud.size(); i++){
+        expanded.spheres.push_back(cloud.sphere(i));
+    }
+    scene.cloud = &cloud;
+
+    Camera<3> camera(64, 48);
+    bmp::Image streamed = render<3>(scene, camera);
+    utv_test("Test cloud matches spheres", max_difference(streamed, render<3>(expanded, camera)) <= 1);
+    utv_test("Test cloud wavefront", max_difference(streamed, render<3>(scene, camera, Engine::wavefront)) <= 1);
+
+    // a budget of a few pages gives the same frame
+    SphereCloud<3> paged(path, 4 * 4096);
+    scene.cloud = &paged;
+    bmp::Image small = render<3>(scene, camera);
+    PageCache::Stats stats = paged.stats();
+    utv_test("Test cloud budget", max_difference(streamed, small) == 0 && stats.evictions > 0 &&
+                                  stats.peak_resident <= 4 * 4096 && stats.faults > stats.evictions);
+
+    // a file cut short under the renderer fails the frame, not the process
+    SphereCloud<3> broken(path, 4 * 4096);
+    ofstream(path, ios::binary).close();
+    scene.cloud = &broken;
+    Renderer<3> threaded(camera, 3);
+    threaded.scene() = scene;
+    bool thrown = false;
+    try{
+        threaded.render();
+    }
+    catch(const ios_base::failure&){
+        thrown = true;
+    }
+    utv_test("Test cloud read error", thrown);
+
+    // the ids keep the whole index, past the 24 bits of the old ones
+    size_t far = (size_t(1) << 24) + 5;
+    uint64_t far_id = object_id(Hit{1, Shape::cloud, far});
+    utv_test("Test cloud ids", far_id != object_id(Hit{1, Shape::cloud, 5}) && id_index(far_id) == far &&
+                               id_shape(far_id) == Shape::cloud);
+
+    remove(path.c_str());
+}
+
+static string file_bytes(const string& path){
+    ifstream file(path, ios::binary);
+    return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+void UnitTest::test_strips(){
+    string full_path = "./test_bmp_images/test_full.bmp";
+    string strips_path = "./test_bmp_images/test_strips.bmp";
+
+    // not a multiple of the tile size
+    Camera<4> camera(100, 70);
+    Glyphs glyphs;
+    auto label = [&](bmp::Image& img, size_t row0){ glyphs.imprint(img, "4D", V2<size_t>(10, 20), 0.75, row0); };
+
+    Renderer<4> renderer(camera);
+    renderer.scene() = test_scene();
+    renderer.light_samples(2);
+
+    bmp::Image full = renderer.render();
+    label(full, 0);
+    full.write(full_path);
+
+    // the label crosses the strips of 32 rows
+    renderer.frame_index(0);
+    renderer.render_strips(strips_path, 20, label);
+    utv_test("Test strips same file", file_bytes(full_path) == file_bytes(strips_path));
+    utv_test("Test strips bounded memory", renderer.image().height() == 70 - 64 && renderer.frame_index() == 1);
+
+    renderer.engine(Engine::wavefront);
+    renderer.frame_index(0);
+    renderer.render().write(full_path);
+    renderer.frame_index(0);
+    renderer.render_strips(strips_path, 16);
+    utv_test("Test strips wavefront", file_bytes(full_path) == file_bytes(strips_path));
+
+    // an aborted frame leaves no file behind
+    atomic<bool> stop(true);
+    renderer.abort_on(&stop);
+    bool finished = renderer.render_strips(strips_path, 16);
+    renderer.abort_on(nullptr);
+    utv_test("Test strips abort", !finished && !ifstream(strips_path).good());
+
+    remove(full_path.c_str());
+    remove(strips_path.c_str());
+}
+
+void UnitTest::test_slices(){
+    Camera<4> camera(64, 48);
+    camera.position = V4d(0.5, 0, 0, 0.25);
+    vector<double> offsets = {0.5, -1.5, 0, 2.5, -0.75};
+
+    SliceBatch<4> batch(camera, 2);
+    batch.scene() = test_scene();
+    vector<bmp::Image> images = batch.render(offsets);
+
+    bool same = images.size() == offsets.size();
+    for(size_t k = 0; same && k < offsets.size(); k++){
+        Camera<4> moved = camera;
+        moved.position = camera.position + camera.axes[3] * offsets[k];
+        same = max_difference(images[k], render_slice(test_scene(), moved)) <= 1;
+    }
+    utv_test("Test slices match render_slice", same);
+
+    // wavefront, a threaded renderer and the offsets in another order
+    batch.renderer().engine(Engine::wavefront);
+    vector<double> reversed(offsets.rbegin(), offsets.rend());
+    vector<bmp::Image> again = batch.render(reversed);
+    same = true;
+    for(size_t k = 0; k < offsets.size(); k++){
+        same = same && max_difference(images[k], again[offsets.size() - 1 - k]) <= 1;
+    }
+    utv_test("Test slices wavefront and order", same);
+
+    // a sweep through spheres spread along w, each slice cuts a few
+    SliceBatch<4> sweep(Camera<4>(32, 32));
+    Scene<4>& scene = sweep.scene();
+    for(size_t n = 0; n < 256; n++){
+        double w = -16 + n * 0.125;
+        scene.spheres.push_back(Sphere<4>(V4d(-6 + (n % 13), -6 + (n % 11), -20, w), 0.5, Color(0.8), Color(0), 0, 0));
+    }
+    scene.spheres.push_back(Sphere<4>(V4d(0, 20, 0, 0), 100, Color(0), Color(1), 0, 0));
+
+    vector<double> ws;
+    for(size_t k = 0; k < 64; k++){
+        ws.push_back(-16 + k * 0.5);
+    }
+    vector<bmp::Image> swept = sweep.render(ws);
+
+    Camera<4> moved(32, 32);
+    moved.position = moved.axes[3] * ws[37];
+    utv_test("Test slices sweep", max_difference(swept[37], render_slice(scene, moved)) <= 1);
+    // the large light and the 8 spheres within 0.5 of every offset
+    utv_test("Test slices culled", sweep.spheres_visited() <= 64 * 9);
+
+    bmp::Image sheet = contact_sheet(swept, 8);
+    utv_test("Test contact sheet size", sheet.width() == 8 * 32 + 7 * 2 && sheet.height() == 8 * 32 + 7 * 2);
+    utv_test("Test contact sheet cell", sheet.pixelArray.get(34 + 5, 7).r() == swept[1].pixelArray.get(5, 7).r());
+}
+
+// a square lattice of n x n small spheres spanning size at distance z
+static Scene<4> lattice(size_t n, double size, double z){
+    Scene<4> scene;
+    scene.planes.push_back(Plane<4>(V4d(0, -4, 0, 0), V4d(0, 1, 0, 0), Color(0.2), Color(0), 0, 0));
+    scene.spheres.push_back(Sphere<4>(V4d(0, 20, 0, 0), 3, Color(0), Color(3), 0, 0));
+    double step = size / n;
+    for(size_t i = 0; i < n; i++){
+        for(size_t j = 0; j < n; j++){
+            V4d center(-size / 2 + (i + 0.5) * step, -size / 2 + (j + 0.5) * step, z, 0);
+            scene.spheres.push_back(Sphere<4>(center, 0.3 * step, Color(1, 0.5 * (i % 2), 0.5 * (j % 2)), Color(0), 0, 0));
+        }
+    }
+    return scene;
+}
+
+void UnitTest::test_lod(){
+    Camera<4> camera(64, 48);
+
+    // off by default, then every sphere covers several pixels
+    Renderer<4> near(camera);
+    near.scene() = lattice(8, 8, -12);
+    bmp::Image full = near.render();
+    utv_test("Test lod off", &near.traced() == &near.scene());
+    near.level_of_detail(1);
+    utv_test("Test lod keeps large spheres", max_difference(near.render(), full) <= 1 && near.traced().spheres.size() == near.scene().spheres.size());
+
+    // 1600 spheres of a tenth of a pixel
+    Renderer<4> far(camera);
+    far.scene() = lattice(40, 8, -100);
+    bmp::Image reference = far.render();
+    far.level_of_detail(1);
+    bmp::Image merged = far.render();
+    size_t cut = far.traced().spheres.size();
+    utv_test("Test lod merges tiny spheres", cut < 1601 / 4);
+
+    bool light = false;
+    for(const Sphere<4>& s : far.traced().spheres){
+        light = light || s == far.scene().spheres[0];
+    }
+    utv_test("Test lod keeps the lights", light);
+
+    // the lattice averages out, the mean stays close
+    double total = 0;
+    for(int i = 0; i < merged.width(); i++){
+        for(int j = 0; j < merged.height(); j++){
+            for(size_t k = 0; k < 3; k++){
+                total += abs(int(merged.pixelArray.get(i, j)[k]) - int(reference.pixelArray.get(i, j)[k]));
+            }
+        }
+    }
+    utv_test("Test lod close to full detail", total / (3 * 64 * 48) < 8);
+
+    // 4 times the spheres on the same pixels, about the same cut
+    far.scene() = lattice(80, 8, -100);
+    far.render();
+    utv_test("Test lod bounded", far.traced().spheres.size() < 2 * cut);
+}
+
+void UnitTest::test_aux_output(){
+    string raw_path = "./test_bmp_images/test_aux.raw";
+    string prefix = "./test_bmp_images/test_aux";
+    Camera<4> camera(64, 48);
+
+    AuxBuffers aux;
+    bmp::Image img = render<4>(test_scene(), camera, aux);
+    utv_test("Test aux same image", max_difference(img, render<4>(test_scene(), camera)) == 0);
+
+    // glass and mirror pixels go deeper, the background doesn't
+    uint64_t glass = object_id(Hit{1, Shape::sphere, 0});
+    uint64_t mirror = object_id(Hit{1, Shape::sphere, 1});
+    bool depths = true;
+    size_t specular = 0;
+    for(size_t p = 0; p < aux.id.size(); p++){
+        if(aux.id[p] == glass || aux.id[p] == mirror){
+            depths = depths && aux.ray_depth[p] >= 1;
+            specular++;
+        }
+        else if(aux.id[p] == 0){
+            depths = depths && aux.ray_depth[p] == 0;
+        }
+        depths = depths && aux.ray_depth[p] <= MAX_RAY_DEPTH;
+    }
+    utv_test("Test aux ray depth", depths && specular > 0);
+
+    // the wavefront drops the rays with no weight left, the rest agrees
+    AuxBuffers wave;
+    render<4>(test_scene(), camera, wave, Engine::wavefront);
+    size_t same = 0;
+    for(size_t p = 0; p < aux.id.size(); p++){
+        same += wave.ray_depth[p] == aux.ray_depth[p] && wave.id[p] == aux.id[p];
+    }
+    utv_test("Test aux wavefront", same >= aux.id.size() * 99 / 100);
+
+    aux.write(raw_path);
+    string raw = file_bytes(raw_path);
+    utv_test("Test aux raw file", raw.size() == 7 + 8 + 64 * 48 * (12 + 12 + 4 + 8 + 1 + 1) &&
+                                  raw.compare(0, 7, "4TAUX2\n") == 0);
+
+    aux.write_pfm(prefix);
+    string depth = file_bytes(prefix + "_depth.pfm");
+    string color = file_bytes(prefix + "_color.pfm");
+    string header = "Pf\n64 48\n-1.0\n";
+    float corner;
+    memcpy(&corner, depth.data() + header.size(), sizeof(float));
+    utv_test("Test aux pfm files", depth.compare(0, header.size(), header) == 0 &&
+                                   depth.size() == header.size() + 64 * 48 * 4 &&
+                                   color.size() == header.size() + 64 * 48 * 12 &&
+                                   corner == aux.depth[47 * 64]);
+
+    // the id file gives back the shape and index of every pixel
+    string ids = file_bytes(prefix + "_id.pfm");
+    string id_header = "PF\n64 48\n-1.0\n";
+    bool exact = ids.compare(0, id_header.size(), id_header) == 0 &&
+                 ids.size() == id_header.size() + 64 * 48 * 12;
+    size_t glass_pixels = 0, mirror_pixels = 0;
+    for(size_t y = 0; exact && y < 48; y++){
+        for(size_t x = 0; x < 64; x++){
+            float channels[3];
+            memcpy(channels, ids.data() + id_header.size() + ((47 - y) * 64 + x) * 12, sizeof(channels));
+            uint64_t id = uint64_t(channels[0]) << 56 | uint64_t(channels[2]) << 24 | uint64_t(channels[1]);
+            exact = exact && id == aux.id[y * 64 + x];
+            glass_pixels += id == glass;
+            mirror_pixels += id == mirror;
+        }
+    }
+    utv_test("Test aux pfm ids", exact && glass_pixels > 0 && mirror_pixels > 0);
+
+    remove(raw_path.c_str());
+    for(string channel : {"color", "normal", "depth", "id", "ray_depth"}){
+        remove((prefix + "_" + channel + ".pfm").c_str());
+    }
+}
+
+void UnitTest::test_glyphs(){
+    // the compiled in font is the one of the bmp
+    Glyphs embedded;
+    Glyphs loaded("./bmp_font/bmp_if_font_5.bmp");
+    bool same = true;
+    for(int c = 32; c < 127; c++){
+        same = same && max_difference(embedded.get_char(c), loaded.get_char(c)) == 0;
+    }
+    utv_test("Test glyphs embedded font", same);
+
+    bmp::Image a(80, 40), b(80, 40);
+    embedded.imprint(a, "4D w", V2<size_t>(2, 4), 0.6);
+    loaded.imprint(b, "4D w", V2<size_t>(2, 4), 0.6);
+    bool inked = false;
+    for(int i = 0; i < a.width(); i++){
+        for(int j = 0; j < a.height(); j++){
+            inked = inked || a.pixelArray.get(i, j).r() == 255;
+        }
+    }
+    utv_test("Test glyphs imprint", max_difference(a, b) == 0 && inked);
+}
+
+void UnitTest::test_image_ops(){
+    // a smooth gradient with some noise
+    bmp::Image img(100, 60);
+    uint32_t seed = 1;
+    for(int i = 0; i < 100; i++){
+        for(int j = 0; j < 60; j++){
+            seed = seed * 1664525 + 1013904223;
+            img.pixelArray.set(i, j, bmp::Color(i * 2, j * 4, 100 + (seed >> 28)));
+        }
+    }
+
+    // per pixel references of the filters
+    bmp::Image box = imgops::resize(img, 30, 20, imgops::Filter::box);
+    int box_error = 0;
+    for(int x = 0; x < 30; x++){
+        for(int y = 0; y < 20; y++){
+            int x0 = x * 100 / 30, x1 = (x + 1) * 100 / 30, y0 = y * 60 / 20, y1 = (y + 1) * 60 / 20;
+            for(size_t c = 0; c < 3; c++){
+                double sum = 0;
+                for(int i = x0; i < x1; i++){
+                    for(int j = y0; j < y1; j++){
+                        sum += img.pixelArray.get(i, j)[c];
+                    }
+                }
+                int mean = lround(sum / ((x1 - x0) * (y1 - y0)));
+                box_error = max(box_error, abs(mean - int(box.pixelArray.get(x, y)[c])));
+            }
+        }
+    }
+    utv_test("Test image box resize", box_error <= 1);
+
+    bmp::Image up = imgops::resize(img, 230, 170);
+    int bilinear_error = 0;
+    for(int x = 0; x < 230; x++){
+        for(int y = 0; y < 170; y++){
+            double sx = min(99., max(0., (x + 0.5) * 100 / 230 - 0.5));
+            double sy = min(59., max(0., (y + 0.5) * 60 / 170 - 0.5));
+            int i0 = sx, j0 = sy, i1 = min(99, i0 + 1), j1 = min(59, j0 + 1);
+            double fx = sx - i0, fy = sy - j0;
+            for(size_t c = 0; c < 3; c++){
+                double v = (img.pixelArray.get(i0, j0)[c] * (1 - fx) + img.pixelArray.get(i1, j0)[c] * fx) * (1 - fy) +
+                           (img.pixelArray.get(i0, j1)[c] * (1 - fx) + img.pixelArray.get(i1, j1)[c] * fx) * fy;
+                bilinear_error = max(bilinear_error, abs(int(lround(v)) - int(up.pixelArray.get(x, y)[c])));
+            }
+        }
+    }
+    utv_test("Test image bilinear resize", bilinear_error <= 1);
+
+    ThreadPool pool(4);
+    utv_test("Test image resize threaded", max_difference(imgops::resize(img, 230, 170, imgops::Filter::bilinear, &pool), up) == 0 &&
+                                           max_difference(imgops::resize(img, 30, 20, imgops::Filter::box, &pool), box) == 0);
+
+    vector<bmp::Image> chain = imgops::mips(img);
+    bmp::Image thumb = imgops::thumbnail(img, 32, 32);
+    utv_test("Test image mips", chain.size() == 7 && chain[1].width() == 50 && chain[1].height() == 30 &&
+                                chain[6].width() == 1 && chain[6].height() == 1);
+    utv_test("Test image thumbnail", thumb.width() == 32 && thumb.height() == 19);
+
+    // a whole large frame under one pixel
+    bmp::Image grey(6000, 4000);
+    fill(grey.pixelArray.data(), grey.pixelArray.data() + 6000 * 4000, bmp::Color(200));
+    bmp::Image dot = imgops::resize(grey, 1, 1, imgops::Filter::box);
+    utv_test("Test image box resize large", dot.pixelArray.get(0, 0) == bmp::Color(200) &&
+                                            imgops::resize(grey, 3, 2, imgops::Filter::box).pixelArray.get(2, 1) == bmp::Color(200));
+
+    // crop and blit back, partly out of the image
+    bmp::Image part = imgops::crop(img, 90, -5, 20, 15);
+    bmp::Image copy(100, 60);
+    imgops::blit(copy, part, 90, 0);
+    utv_test("Test image crop blit", part.width() == 10 && part.height() == 10 &&
+                                     copy.pixelArray.get(95, 7) == img.pixelArray.get(95, 7) &&
+                                     copy.pixelArray.get(89, 7) == bmp::Color(0));
+
+    bmp::Image white(10, 10), base(20, 20);
+    for(int i = 0; i < 10; i++){
+        for(int j = 0; j < 10; j++){
+            white.pixelArray.set(i, j, bmp::Color(255));
+        }
+    }
+    imgops::blend(base, white, 128, -5, 15);
+    utv_test("Test image blend", base.pixelArray.get(0, 15) == bmp::Color(128) && base.pixelArray.get(5, 15) == bmp::Color(0) &&
+                                 base.pixelArray.get(0, 14) == bmp::Color(0));
+
+    vector<uint8_t> alpha(100, 0);
+    alpha[3 * 10 + 4] = 255;
+    alpha[3 * 10 + 5] = 64;
+    imgops::over(base, white, alpha, 10, 0, &pool);
+    utv_test("Test image over", base.pixelArray.get(13, 4) == bmp::Color(255) && base.pixelArray.get(13, 5) == bmp::Color(64) &&
+                                base.pixelArray.get(13, 6) == bmp::Color(0));
+}
@@ -0,0 +1,122 @@
+#include "VideoStream.h"
+
+#include <ios>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+using namespace std;
+using namespace enc;
+
+
+VideoStream::VideoStream(string filename, Format format, unsigned fps, size_t buffer_size) :
+    file(nullptr),
+    to_stdout(filename == "-"),
+    format(format),
+    fps(fps),
+    width(0),
+    height(0),
+    nframes(0),
+    io_buffer(buffer_size)
+{
+    if(to_stdout){
+#ifdef _WIN32
+        // the frames are binary, avoid the \n -> \r\n translation
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        file = stdout;
+    }
+    else{
+        file = fopen(filename.c_str(), "wb");
+    }
+
+    if(!file){
+        throw ios_base::failure("Opening video stream went wrong");
+    }
+
+    // stdout may already have been written to, its buffer can't be changed
+    if(!to_stdout && buffer_size > 0){
+        setvbuf(file, io_buffer.data(), _IOFBF, io_buffer.size());
+    }
+}
+
+VideoStream::~VideoStream(){
+    close();
+}
+
+void VideoStream::close(){
+    if(!file){
+        return;
+    }
+
+    fflush(file);
+    if(!to_stdout){
+        fclose(file);
+    }
+    file = nullptr;
+}
+
+void VideoStream::write_header(){
+    if(format == Y4M){
+        string header = "YUV4MPEG2 W" + numtostr(width) + " H" + numtostr(height) +
+                        " F" + numtostr(fps) + ":1 Ip A1:1 C444\n";
+        fwrite(header.data(), 1, header.size(), file);
+    }
+}
+
+void VideoStream::write(const bmp::Image& img){
+    if(!file){
+        throw ios_base::failure("Writing to a closed video stream");
+    }
+
+    if(nframes == 0){
+        width = img.width();
+        height = img.height();
+        frame.resize(3 * width * height);
+        write_header();
+    }
+    else if(size_t(img.width()) != width || size_t(img.height()) != height){
+        throw ios_base::failure("Frame size differs from the video stream size");
+    }
+
+    size_t npixels = width * height;
+
+    if(format == Y4M){
+        // BT.601 limited range, planar Y, Cb, Cr at full resolution
+        uint8_t* py = frame.data();
+        uint8_t* pu = py + npixels;
+        uint8_t* pv = pu + npixels;
+
+        for(size_t y = 0; y < height; y++){
+            for(size_t x = 0; x < width; x++){
+                bmp::Color c = img.pixelArray.get(x, y);
+                int r = c[0], g = c[1], b = c[2];
+
+                *py++ = (( 66 * r + 129 * g +  25 * b + 128) >> 8) +  16;
+                *pu++ = ((-38 * r -  74 * g + 112 * b + 128) >> 8) + 128;
+                *pv++ = ((112 * r -  94 * g -  18 * b + 128) >> 8) + 128;
+            }
+        }
+
+        fwrite("FRAME\n", 1, 6, file);
+    }
+    else{
+        uint8_t* s = frame.data();
+        for(size_t y = 0; y < height; y++){
+            for(size_t x = 0; x < width; x++){
+                bmp::Color c = img.pixelArray.get(x, y);
+                *s++ = c[0];
+                *s++ = c[1];
+                *s++ = c[2];
+            }
+        }
+    }
+
+    if(fwrite(frame.data(), 1, frame.size(), file) != frame.size()){
+        throw ios_base::failure("Writing to the video stream went wrong");
+    }
+
+    nframes++;
+}
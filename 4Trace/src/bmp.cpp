@@ -2,6 +2,9 @@
 
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <cmath>
+#include <cstdio>
 
 using namespace std;
 using namespace bmp;
@@ -101,9 +104,7 @@ std::ostream& operator<<(std::ostream& os, const InfoHeader& bmih){
     return os;
 }
 
-Image::Image(int width, int height){
-    // initialize headers
-
+void bmp::headers(int width, int height, FileHeader& file_header, InfoHeader& info_header){
     // initialize file header
     file_header.bfType[0] = 'B';
     file_header.bfType[1] = 'M';
@@ -111,19 +112,20 @@ Image::Image(int width, int height){
     file_header.bfReserved1 = 0;
     file_header.bfReserved2 = 0;
 
-    file_header.bfOffBits = size_headers;
+    file_header.bfOffBits = Image::size_headers;
 
     // initialize the width/height/bbp to calculate the size
     info_header.biBitCount = 24;
     info_header.biWidth = width;
     info_header.biHeight = height;
 
-    // total file size
+    // total file size, 0 if it doesn't fit
     size_t rowSize = ceil(info_header.biBitCount * info_header.biWidth / 32.0) * 4;
-    file_header.bfSize = abs(height) * rowSize + size_headers;
+    uint64_t size = uint64_t(abs(height)) * rowSize + file_header.bfOffBits;
+    file_header.bfSize = size > UINT32_MAX ? 0 : size;
 
     // size of info header
-    info_header.biSize = size_info_header;
+    info_header.biSize = Image::size_info_header;
     info_header.biPlanes = 1;
     info_header.biCompression = 0;
 
@@ -133,6 +135,11 @@ Image::Image(int width, int height){
     info_header.biYPelsPerMeter = 0;
     info_header.biClrUsed = 0;
     info_header.biClrImportant = 0;
+}
+
+Image::Image(int width, int height){
+    // initialize headers
+    headers(width, height, file_header, info_header);
 
     // initialize matrix
     pixelArray = Matrix<Color>(info_header.biWidth, info_header.biHeight);
@@ -188,46 +195,100 @@ Image::Image(string filename){
 }
 
 
+// row y of the image (from the top) in the bgr order of the file, the
+// pad bytes of row are left alone
+static void encode_row(Image& img, int y, char* row){
+    for(int ic = 0; ic < img.width(); ic++){
+        Color c = img.pixelArray.get(ic, y);
+        *(row) = c.b(); row++;
+        *(row) = c.g(); row++;
+        *(row) = c.r(); row++;
+    }
+}
+
+static size_t row_size(const InfoHeader& info_header){
+    // pad so that is multiple of ints
+    // (24 + 24 = 48) -> (48 - 32 + 32 = 64) -> (64 - 48 = 6)
+    return ceil(info_header.biBitCount * info_header.biWidth / 32.0) * 4;
+}
+
 void Image::write(string filename){
-    char s[file_header.bfSize] = {'n'};
-    char* s_ptr = s;
+    ofstream bmpfile(filename, ios::binary);
+    if(!bmpfile.is_open()){
+        throw ios_base::failure("Opening file to write went wrong");
+    }
 
+    char s[size_headers];
     // write file header
-    file_header.write(s_ptr);
+    file_header.write(s);
     // write info header
-    info_header.write(s_ptr + size_file_header);
+    info_header.write(s + size_file_header);
+    bmpfile.write(s, size_headers);
+
+    // one row at a time, the file isn't built in memory
+    vector<char> row(row_size(info_header), 0);
+    for(size_t nrow = 0; nrow < size_t(abs(info_header.biHeight)); nrow++){
+        encode_row(*this, info_header.biHeight - 1 - nrow, row.data());
+        bmpfile.write(row.data(), row.size());
+    }
 
-    // move pixel to the start of the pixelArray position
-    s_ptr += size_headers;
+    if(!bmpfile){
+        throw ios_base::failure("Writing the bmp file went wrong");
+    }
+}
 
-    // pad so that is multiple of ints
-    // (24 + 24 = 48) -> (48 - 32 + 32 = 64) -> (64 - 48 = 6)
-    size_t rowSize = ceil(info_header.biBitCount * info_header.biWidth / 32.0) * 4;
-    size_t npad = rowSize - info_header.biWidth*(info_header.biBitCount/8);
 
-    for(size_t nrow = 0; nrow < abs(info_header.biHeight); nrow++){
+StripWriter::StripWriter(const string& filename, int width, int height) :
+    file(filename, ios::binary),
+    filename(filename),
+    width(width),
+    height(height),
+    rows_written(0)
+{
+    if(!file.is_open()){
+        throw ios_base::failure("Opening file to write went wrong");
+    }
 
-        // for each pixel write the the byte corresponding to rgb
-        for(int ic = 0; ic < info_header.biWidth; ic++){
-            Color c = pixelArray.get(ic, info_header.biHeight - 1 - nrow);
-            *(s_ptr) = c.b(); s_ptr++;
-            *(s_ptr) = c.g(); s_ptr++;
-            *(s_ptr) = c.r(); s_ptr++;
-        }
+    FileHeader file_header;
+    InfoHeader info_header;
+    headers(width, height, file_header, info_header);
 
-        // fill the pad bytes
-        for(size_t i = 0; i < npad; i++){
-            *(s_ptr) = 0;
-            s_ptr++;
-        }
+    char s[Image::size_headers];
+    file_header.write(s);
+    info_header.write(s + Image::size_file_header);
+    file.write(s, sizeof(s));
+
+    row.assign(row_size(info_header), 0);
+}
+
+void StripWriter::write(Image& strip){
+    if(strip.width() != width || rows_written + strip.height() > height){
+        throw ios_base::failure("Strip doesn't fit the bmp file");
     }
 
-    ofstream bmpfile(filename, ios::binary);
-    if(bmpfile.is_open()){
-        bmpfile.write(s, file_header.bfSize);
+    for(int y = strip.height() - 1; y >= 0; y--){
+        encode_row(strip, y, row.data());
+        file.write(row.data(), row.size());
     }
-    else{
-        throw ios_base::failure("Opening file to write went wrong");
+    rows_written += strip.height();
+
+    if(!file){
+        throw ios_base::failure("Writing the bmp file went wrong");
+    }
+}
+
+void StripWriter::discard(){
+    file.close();
+    std::remove(filename.c_str());
+}
+
+void StripWriter::close(){
+    if(rows_written != height){
+        throw ios_base::failure("The strips don't cover the bmp file");
+    }
+    file.close();
+    if(!file){
+        throw ios_base::failure("Writing the bmp file went wrong");
     }
 }
 